@@ -0,0 +1,185 @@
+/// @file ColumnarWriter.cpp
+/// @brief Implementación del escritor del formato columnar GICF.
+
+#include "ColumnarWriter.h"
+#include <QIODevice>
+#include <QtEndian>
+#include <limits>
+
+namespace {
+/// Tipos de columna del formato GICF.
+enum ColumnType : quint8 { Int32 = 1, String = 2, Dictionary = 3, Date32 = 4 };
+
+/// Versión del formato que se escribe.
+const quint16 kFormatVersion = 1;
+/// Valor que representa un nulo en columnas INT32 y DATE32.
+const qint32 kNull = std::numeric_limits<qint32>::min();
+/// Primer día del calendario de DATE32.
+const QDate kEpoch(1970, 1, 1);
+
+/// @brief Añade un entero en little-endian al final del búfer.
+template <typename T>
+void appendLE(QByteArray &out, T value)
+{
+    const T le = qToLittleEndian(value);
+    out.append(reinterpret_cast<const char *>(&le), int(sizeof(T)));
+}
+
+/// @brief Añade una columna de enteros precedida de su longitud en bytes.
+void appendInt32Column(QByteArray &out, const std::vector<qint32> &values)
+{
+    appendLE<quint32>(out, quint32(values.size() * sizeof(qint32)));
+    for (qint32 v : values)
+        appendLE<qint32>(out, v);
+}
+}
+
+/// @brief Añade el valor de una fila y lo registra en el diccionario si aparece por primera vez.
+/// @param value Cadena de la fila.
+void ColumnarWriter::DictionaryColumn::append(const QString &value)
+{
+    auto it = ids.constFind(value);
+    if (it == ids.constEnd()) {
+        it = ids.insert(value, quint32(ids.size()));
+        pending.push_back(value.toUtf8());
+    }
+    indices.push_back(it.value());
+}
+
+/// @brief Escribe la columna del grupo en curso (entradas nuevas e índices) y la vacía.
+/// @param group Búfer del grupo de filas.
+void ColumnarWriter::DictionaryColumn::flushTo(QByteArray &group)
+{
+    QByteArray data;
+    appendLE<quint32>(data, quint32(pending.size()));
+    for (const QByteArray &entry : pending) {
+        appendLE<quint32>(data, quint32(entry.size()));
+        data.append(entry);
+    }
+    for (quint32 index : indices)
+        appendLE<quint32>(data, index);
+    appendLE<quint32>(group, quint32(data.size()));
+    group.append(data);
+    pending.clear();
+    indices.clear();
+}
+
+/// @brief Constructor de ColumnarWriter.
+/// @param rowGroupSize Filas por grupo (mínimo 1).
+ColumnarWriter::ColumnarWriter(int rowGroupSize)
+    : m_rowGroupSize(rowGroupSize < 1 ? 1 : rowGroupSize)
+    , m_device(nullptr)
+    , m_position(0)
+    , m_totalRows(0)
+{}
+
+/// @brief Escribe la cabecera con el esquema de columnas.
+/// @param device Dispositivo abierto para escritura.
+/// @return true si la cabecera se escribe correctamente.
+bool ColumnarWriter::open(QIODevice *device)
+{
+    m_device = device;
+    m_position = 0;
+    m_totalRows = 0;
+    m_groupOffsets.clear();
+
+    const struct { ColumnType type; const char *name; } columns[] = {
+        { Int32, "id" }, { String, "name" }, { Dictionary, "type" }, { Int32, "quantity" },
+        { Dictionary, "location" }, { Date32, "purchase_date" }, { Int32, "reorder_threshold" },
+    };
+    QByteArray header("GICF");
+    appendLE<quint16>(header, kFormatVersion);
+    appendLE<quint16>(header, quint16(sizeof(columns) / sizeof(*columns)));
+    for (const auto &column : columns) {
+        const QByteArray name(column.name);
+        header.append(char(column.type));
+        appendLE<quint16>(header, quint16(name.size()));
+        header.append(name);
+    }
+    return write(header);
+}
+
+/// @brief Añade un componente al grupo en curso.
+/// @param component Componente a añadir.
+/// @return true si no hay errores al escribir un grupo completo.
+bool ColumnarWriter::append(const Component &component)
+{
+    if (m_nameOffsets.empty())
+        m_nameOffsets.push_back(0);
+
+    m_ids.push_back(component.id());
+    m_nameBytes.append(component.name().toUtf8());
+    m_nameOffsets.push_back(quint32(m_nameBytes.size()));
+    m_types.append(component.type());
+    m_quantities.push_back(component.quantity());
+    m_locations.append(component.location());
+    m_dates.push_back(component.purchaseDate().isValid()
+                          ? qint32(kEpoch.daysTo(component.purchaseDate()))
+                          : kNull);
+    m_thresholds.push_back(component.hasReorderThreshold() ? component.reorderThreshold() : kNull);
+
+    if (int(m_ids.size()) >= m_rowGroupSize)
+        return flushRowGroup();
+    return true;
+}
+
+/// @brief Escribe el grupo pendiente y el pie con el índice de grupos.
+/// @return true si el archivo se completa correctamente.
+bool ColumnarWriter::finish()
+{
+    if (!m_ids.empty() && !flushRowGroup())
+        return false;
+
+    QByteArray footer;
+    appendLE<quint32>(footer, quint32(m_groupOffsets.size()));
+    for (quint64 offset : m_groupOffsets)
+        appendLE<quint64>(footer, offset);
+    appendLE<quint64>(footer, m_totalRows);
+    appendLE<quint32>(footer, quint32(footer.size()));
+    footer.append("GICF");
+    return write(footer);
+}
+
+/// @brief Serializa las columnas del grupo en curso y vacía los búferes.
+/// @return true si el grupo se escribe correctamente.
+bool ColumnarWriter::flushRowGroup()
+{
+    const quint32 rows = quint32(m_ids.size());
+    QByteArray group;
+    group.reserve(int(rows) * 24 + m_nameBytes.size());
+    appendLE<quint32>(group, rows);
+
+    appendInt32Column(group, m_ids);
+
+    appendLE<quint32>(group, quint32(m_nameOffsets.size() * sizeof(quint32) + m_nameBytes.size()));
+    for (quint32 offset : m_nameOffsets)
+        appendLE<quint32>(group, offset);
+    group.append(m_nameBytes);
+
+    m_types.flushTo(group);
+    appendInt32Column(group, m_quantities);
+    m_locations.flushTo(group);
+    appendInt32Column(group, m_dates);
+    appendInt32Column(group, m_thresholds);
+
+    m_groupOffsets.push_back(m_position);
+    m_totalRows += rows;
+    m_ids.clear();
+    m_nameOffsets.clear();
+    m_nameBytes.clear();
+    m_quantities.clear();
+    m_dates.clear();
+    m_thresholds.clear();
+    return write(group);
+}
+
+/// @brief Escribe bytes en el dispositivo de destino.
+/// @param data Datos a escribir.
+/// @return true si se escriben por completo.
+bool ColumnarWriter::write(const QByteArray &data)
+{
+    if (!m_device || m_device->write(data) != data.size())
+        return false;
+    m_position += quint64(data.size());
+    return true;
+}
@@ -0,0 +1,93 @@
+/// @file ColumnarWriter.h
+/// @brief Declaración de la clase ColumnarWriter, que escribe el formato columnar tipado GICF.
+
+#ifndef COLUMNARWRITER_H
+#define COLUMNARWRITER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <vector>
+#include "Component.h"
+
+class QIODevice;
+
+/// @class ColumnarWriter
+/// @brief Escribe componentes en el formato columnar autodescriptivo GICF por grupos de filas.
+///
+/// Formato GICF v1 (todos los enteros en little-endian):
+/// - Cabecera: "GICF", u16 versión (1), u16 número de columnas y, por columna,
+///   u8 tipo, u16 longitud del nombre y nombre en UTF-8.
+///   Tipos: 1 = INT32, 2 = STRING (UTF-8), 3 = DICT (cadena codificada con diccionario),
+///   4 = DATE32 (días desde 1970-01-01).
+/// - Grupos de filas: u32 número de filas y, por columna, u32 longitud en bytes y datos:
+///   - INT32 / DATE32: un i32 por fila. Los nulos son INT32_MIN.
+///   - STRING: (filas + 1) desplazamientos u32 seguidos de los bytes concatenados.
+///   - DICT: u32 número de entradas nuevas del diccionario, cada una como u32 longitud
+///     y bytes UTF-8, seguido de un índice u32 por fila. El diccionario es común a todo
+///     el archivo y cada grupo solo añade las entradas que aparecen por primera vez.
+/// - Pie: u32 número de grupos, u64 desplazamiento de cada grupo, u64 total de filas,
+///   u32 longitud del pie (sin contar este campo ni la marca final) y "GICF".
+///
+/// Columnas: id (INT32), name (STRING), type (DICT), quantity (INT32), location (DICT),
+/// purchase_date (DATE32) y reorder_threshold (INT32, nulo si no se define).
+class ColumnarWriter {
+public:
+    /// @brief Constructor de ColumnarWriter.
+    /// @param rowGroupSize Número de filas por grupo (por defecto 65536).
+    explicit ColumnarWriter(int rowGroupSize = 65536);
+
+    /// @brief Escribe la cabecera en un dispositivo abierto para escritura.
+    /// @param device Dispositivo de destino; no se toma su propiedad.
+    /// @return true si la cabecera se escribe correctamente.
+    bool open(QIODevice *device);
+
+    /// @brief Añade un componente al grupo en curso y lo escribe si se completa.
+    /// @param component Componente a añadir.
+    /// @return true si no hay errores de escritura.
+    bool append(const Component &component);
+
+    /// @brief Escribe el último grupo y el pie del archivo.
+    /// @return true si el archivo se completa correctamente.
+    bool finish();
+
+private:
+    /// @brief Columna de cadenas codificada con diccionario.
+    struct DictionaryColumn {
+        QHash<QString, quint32> ids;      ///< Cadena → índice en el diccionario del archivo.
+        std::vector<QByteArray> pending;  ///< Entradas nuevas del grupo en curso.
+        std::vector<quint32> indices;     ///< Índice de cada fila del grupo.
+
+        /// @brief Añade el valor de una fila, registrándolo en el diccionario si es nuevo.
+        void append(const QString &value);
+
+        /// @brief Escribe las entradas nuevas y los índices del grupo en curso y los vacía.
+        /// @param group Búfer del grupo de filas.
+        void flushTo(QByteArray &group);
+    };
+
+    /// @brief Serializa y escribe el grupo de filas en curso.
+    /// @return true si la escritura es correcta.
+    bool flushRowGroup();
+
+    /// @brief Escribe bytes en el dispositivo y actualiza la posición.
+    /// @return true si se escriben todos los bytes.
+    bool write(const QByteArray &data);
+
+    int m_rowGroupSize;                  ///< Filas por grupo.
+    QIODevice *m_device;                 ///< Dispositivo de destino.
+    quint64 m_position;                  ///< Bytes escritos hasta ahora.
+    quint64 m_totalRows;                 ///< Filas escritas en grupos ya cerrados.
+    std::vector<quint64> m_groupOffsets; ///< Desplazamiento de cada grupo escrito.
+
+    std::vector<qint32> m_ids;           ///< Columna id del grupo en curso.
+    std::vector<quint32> m_nameOffsets;  ///< Desplazamientos de la columna name.
+    QByteArray m_nameBytes;              ///< Bytes concatenados de la columna name.
+    DictionaryColumn m_types;            ///< Columna type.
+    std::vector<qint32> m_quantities;    ///< Columna quantity.
+    DictionaryColumn m_locations;        ///< Columna location.
+    std::vector<qint32> m_dates;         ///< Columna purchase_date (días desde 1970-01-01).
+    std::vector<qint32> m_thresholds;    ///< Columna reorder_threshold.
+};
+
+#endif // COLUMNARWRITER_H
@@ -9,14 +9,17 @@
 /// @param quantity Cantidad inicial disponible del componente.
 /// @param location Ubicación física o lógica del componente.
 /// @param purchaseDate Fecha en que se realizó la compra del componente.
+/// @param reorderThreshold Umbral de reposición propio (-1 si no se define).
 Component::Component(int id, const QString &name, const QString &type, int quantity,
-                     const QString &location, const QDate &purchaseDate)
+                     const QString &location, const QDate &purchaseDate,
+                     int reorderThreshold)
     : m_id(id)
     , m_name(name)
     , m_type(type)
     , m_quantity(quantity)
     , m_location(location)
     , m_purchaseDate(purchaseDate)
+    , m_reorderThreshold(reorderThreshold < 0 ? -1 : reorderThreshold)
 {}
 
 /// @brief Devuelve el identificador del componente.
@@ -61,6 +64,41 @@ QDate Component::purchaseDate() const
     return m_purchaseDate;
 }
 
+/// @brief Devuelve el umbral de reposición propio del componente.
+/// @return Entero con el umbral, o -1 si no se ha definido.
+int Component::reorderThreshold() const
+{
+    return m_reorderThreshold;
+}
+
+/// @brief Indica si el componente tiene un umbral de reposición propio.
+/// @return true si el umbral es mayor o igual a cero.
+bool Component::hasReorderThreshold() const
+{
+    return m_reorderThreshold >= 0;
+}
+
+/// @brief Devuelve las notas libres del componente.
+/// @return Cadena con las notas.
+QString Component::notes() const
+{
+    return m_notes;
+}
+
+/// @brief Devuelve la URL de la hoja de datos del componente.
+/// @return Cadena con la URL.
+QString Component::datasheetUrl() const
+{
+    return m_datasheetUrl;
+}
+
+/// @brief Devuelve el código de barras del componente.
+/// @return Cadena con el código.
+QString Component::barcode() const
+{
+    return m_barcode;
+}
+
 /// @brief Asigna un nuevo identificador al componente.
 /// @param id Nuevo ID a establecer.
 void Component::setId(int id)
@@ -102,3 +140,48 @@ void Component::setPurchaseDate(const QDate &date)
 {
     m_purchaseDate = date;
 }
+
+/// @brief Asigna un nuevo umbral de reposición al componente.
+/// @param threshold Nuevo umbral; los valores negativos se normalizan a -1 (sin umbral propio).
+void Component::setReorderThreshold(int threshold)
+{
+    m_reorderThreshold = threshold < 0 ? -1 : threshold;
+}
+
+/// @brief Asigna nuevas notas al componente.
+/// @param notes Nuevo texto de notas.
+void Component::setNotes(const QString &notes)
+{
+    m_notes = notes;
+}
+
+/// @brief Asigna una nueva URL de hoja de datos al componente.
+/// @param url Nueva URL.
+void Component::setDatasheetUrl(const QString &url)
+{
+    m_datasheetUrl = url;
+}
+
+/// @brief Asigna un nuevo código de barras al componente.
+/// @param barcode Nuevo código.
+void Component::setBarcode(const QString &barcode)
+{
+    m_barcode = barcode;
+}
+
+/// @brief Construye un resumen vacío.
+ComponentSummary::ComponentSummary()
+    : id(-1)
+    , quantity(0)
+{}
+
+/// @brief Copia las columnas de listado de un componente.
+/// @param component Componente completo.
+ComponentSummary::ComponentSummary(const Component &component)
+    : id(component.id())
+    , name(component.name())
+    , type(component.type())
+    , quantity(component.quantity())
+    , location(component.location())
+    , purchaseDate(component.purchaseDate())
+{}
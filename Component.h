@@ -8,6 +8,7 @@
 
 #include <QString>
 #include <QDate>
+#include <QMetaType>
 
 /**
  * @class Component
@@ -27,13 +28,16 @@ public:
      * @param quantity Cantidad de unidades disponibles (por defecto: 0).
      * @param location Ubicación de almacenamiento (por defecto: cadena vacía).
      * @param purchaseDate Fecha de compra del componente (por defecto: fecha actual).
+     * @param reorderThreshold Umbral de reposición propio del componente
+     *        (por defecto: -1, es decir, se usa el umbral de su tipo o el general).
      */
     Component(int id = -1,
               const QString &name = "",
               const QString &type = "",
               int quantity = 0,
               const QString &location = "",
-              const QDate &purchaseDate = QDate::currentDate());
+              const QDate &purchaseDate = QDate::currentDate(),
+              int reorderThreshold = -1);
 
     // Getters
     /**
@@ -72,6 +76,36 @@ public:
      */
     QDate purchaseDate() const;
 
+    /**
+     * @brief Obtiene el umbral de reposición propio del componente.
+     * @return El umbral como entero, o -1 si el componente no define uno.
+     */
+    int reorderThreshold() const;
+
+    /**
+     * @brief Indica si el componente define su propio umbral de reposición.
+     * @return true si reorderThreshold() es mayor o igual a cero.
+     */
+    bool hasReorderThreshold() const;
+
+    /**
+     * @brief Obtiene las notas libres del componente.
+     * @return Las notas como QString (vacío si no hay).
+     */
+    QString notes() const;
+
+    /**
+     * @brief Obtiene la URL de la hoja de datos del componente.
+     * @return La URL como QString (vacío si no hay).
+     */
+    QString datasheetUrl() const;
+
+    /**
+     * @brief Obtiene el código de barras asignado al componente.
+     * @return El código como QString (vacío si no tiene).
+     */
+    QString barcode() const;
+
     // Setters
     /**
      * @brief Establece el identificador único del componente.
@@ -109,6 +143,30 @@ public:
      */
     void setPurchaseDate(const QDate &date);
 
+    /**
+     * @brief Establece el umbral de reposición propio del componente.
+     * @param threshold Nuevo umbral; un valor negativo elimina el umbral propio.
+     */
+    void setReorderThreshold(int threshold);
+
+    /**
+     * @brief Establece las notas libres del componente.
+     * @param notes Nuevo texto de notas.
+     */
+    void setNotes(const QString &notes);
+
+    /**
+     * @brief Establece la URL de la hoja de datos del componente.
+     * @param url Nueva URL.
+     */
+    void setDatasheetUrl(const QString &url);
+
+    /**
+     * @brief Establece el código de barras del componente.
+     * @param barcode Nuevo código; vacío para no asignar ninguno.
+     */
+    void setBarcode(const QString &barcode);
+
 private:
     int m_id;            /**< Identificador único del componente */
     QString m_name;      /**< Nombre descriptivo del componente */
@@ -116,6 +174,43 @@ private:
     int m_quantity;      /**< Número de unidades disponibles */
     QString m_location;  /**< Ubicación de almacenamiento */
     QDate m_purchaseDate;/**< Fecha de compra del componente */
+    int m_reorderThreshold; /**< Umbral de reposición propio (-1 si no se define) */
+    QString m_notes;        /**< Notas libres */
+    QString m_datasheetUrl; /**< URL de la hoja de datos */
+    QString m_barcode;      /**< Código de barras (único si no está vacío) */
+};
+
+Q_DECLARE_METATYPE(Component)
+
+/**
+ * @struct ComponentSummary
+ * @brief Proyección ligera de un componente para listados y búsquedas.
+ *
+ * Contiene solo las columnas que muestran las tablas. Los campos de detalle
+ * (umbral propio, notas, hoja de datos) no se leen en los listados y se
+ * obtienen bajo demanda con el ID, p. ej. al abrir el diálogo de edición.
+ */
+struct ComponentSummary {
+    /**
+     * @brief Construye un resumen vacío (id -1).
+     */
+    ComponentSummary();
+
+    /**
+     * @brief Construye el resumen de un componente completo.
+     * @param component Componente del que se copian las columnas de listado.
+     */
+    explicit ComponentSummary(const Component &component);
+
+    int id;              /**< Identificador único del componente */
+    QString name;        /**< Nombre descriptivo */
+    QString type;        /**< Tipo o categoría */
+    int quantity;        /**< Unidades disponibles */
+    QString location;    /**< Ubicación de almacenamiento */
+    QDate purchaseDate;  /**< Fecha de compra */
 };
+
+Q_DECLARE_METATYPE(ComponentSummary)
+
 #endif // COMPONENT_H
 
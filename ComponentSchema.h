@@ -0,0 +1,393 @@
+/// @file ComponentSchema.h
+/// @brief Descripción en tiempo de compilación de las columnas de Component.
+///
+/// Cada columna de la tabla components se describe una sola vez con un tipo: nombre SQL,
+/// etiquetas, accesores y conversión de valores. Las listas de columnas (Fields) generan a
+/// partir de esos tipos las listas SQL, el enlace de parámetros, la lectura de filas, el
+/// texto de las celdas (CSV, PDF, tabla) y el JSON. Todo se resuelve con plantillas: los
+/// bucles por fila se expanden en llamadas directas, sin tablas de búsqueda ni reflexión.
+///
+/// Para añadir una columna: añadir su accesor a Component, describirla aquí y añadirla a
+/// ValueFields (y a ListFields si aparece en los listados). Las columnas calculadas a partir
+/// de otras (p. ej. purchase_day) solo se escriben y van en DerivedFields. La columna física
+/// sigue creándose con una migración en DatabaseManager.
+#ifndef COMPONENTSCHEMA_H
+#define COMPONENTSCHEMA_H
+
+#include <QDate>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QSqlQuery>
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+#include <QVariant>
+#include <type_traits>
+#include "Component.h"
+
+namespace ComponentSchema {
+
+// ---------------------------------------------------------------------------
+// Conversión de valores
+// ---------------------------------------------------------------------------
+
+/// @brief Entero obligatorio.
+struct Integer {
+    typedef int Value;
+    typedef int Param;
+    static QVariant bind(int value) { return value; }
+    static int decode(const QVariant &value) { return value.toInt(); }
+    static QString text(int value) { return QString::number(value); }
+    static void write(QTextStream &out, int value) { out << value; }
+    static bool isNull(int) { return false; }
+    static QJsonValue json(int value) { return value; }
+};
+
+/// @brief Entero opcional: los negativos se guardan como NULL y NULL se lee como -1.
+struct OptionalInteger {
+    typedef int Value;
+    typedef int Param;
+    static QVariant bind(int value) { return value < 0 ? QVariant(QVariant::Int) : QVariant(value); }
+    static int decode(const QVariant &value) { return value.isNull() ? -1 : value.toInt(); }
+    static QString text(int value) { return value < 0 ? QString() : QString::number(value); }
+    static void write(QTextStream &out, int value) { if (value >= 0) out << value; }
+    static bool isNull(int value) { return value < 0; }
+    static QJsonValue json(int value) { return value; }
+};
+
+/// @brief Texto obligatorio (la cadena vacía se guarda como tal).
+struct Text {
+    typedef QString Value;
+    typedef const QString &Param;
+    static QVariant bind(const QString &value) { return value; }
+    static QString decode(const QVariant &value) { return value.toString(); }
+    static QString text(const QString &value) { return value; }
+    static void write(QTextStream &out, const QString &value) { out << value; }
+    static bool isNull(const QString &) { return false; }
+    static QJsonValue json(const QString &value) { return value; }
+};
+
+/// @brief Texto opcional: la cadena vacía se guarda como NULL.
+struct OptionalText {
+    typedef QString Value;
+    typedef const QString &Param;
+    static QVariant bind(const QString &value) { return value.isEmpty() ? QVariant(QVariant::String) : QVariant(value); }
+    static QString decode(const QVariant &value) { return value.toString(); }
+    static QString text(const QString &value) { return value; }
+    static void write(QTextStream &out, const QString &value) { out << value; }
+    static bool isNull(const QString &value) { return value.isEmpty(); }
+    static QJsonValue json(const QString &value) { return value; }
+};
+
+/// @brief Fecha guardada como texto ISO 8601 (AAAA-MM-DD).
+struct IsoDate {
+    typedef QDate Value;
+    typedef const QDate &Param;
+    static QVariant bind(const QDate &value) { return value.toString(Qt::ISODate); }
+    static QDate decode(const QVariant &value) { return QDate::fromString(value.toString(), Qt::ISODate); }
+    static QString text(const QDate &value) { return value.toString(Qt::ISODate); }
+    static void write(QTextStream &out, const QDate &value) { out << value.toString(Qt::ISODate); }
+    static bool isNull(const QDate &) { return false; }
+    static QJsonValue json(const QDate &value) { return value.toString(Qt::ISODate); }
+};
+
+/// @brief Fecha guardada como número de día (días desde 1970-01-01, igual que
+///        julianday(fecha) - 2440587.5 en SQLite); NULL si la fecha no es válida.
+struct DayNumber {
+    typedef QDate Value;
+    typedef const QDate &Param;
+    static qint64 day(const QDate &value) { return value.toJulianDay() - 2440588; }
+    static QVariant bind(const QDate &value) { return value.isValid() ? QVariant(day(value)) : QVariant(QVariant::LongLong); }
+};
+
+// ---------------------------------------------------------------------------
+// Columnas
+// ---------------------------------------------------------------------------
+
+/// @brief Columna de Component con su conversión, su accesor y su modificador.
+template <typename Codec,
+          typename Codec::Value (Component::*Get)() const,
+          void (Component::*Set)(typename Codec::Param)>
+struct Column {
+    static QVariant bind(const Component &record) { return Codec::bind((record.*Get)()); }
+    static void decode(Component &record, const QVariant &value) { (record.*Set)(Codec::decode(value)); }
+    static QString text(const Component &record) { return Codec::text((record.*Get)()); }
+    static void write(QTextStream &out, const Component &record) { Codec::write(out, (record.*Get)()); }
+    static bool isNull(const Component &record) { return Codec::isNull((record.*Get)()); }
+    static QJsonValue json(const Component &record) { return Codec::json((record.*Get)()); }
+};
+
+/// @brief Columna que además forma parte de ComponentSummary (columnas de listado).
+template <typename Codec,
+          typename Codec::Value (Component::*Get)() const,
+          void (Component::*Set)(typename Codec::Param),
+          typename Codec::Value ComponentSummary::*Member>
+struct ListColumn : Column<Codec, Get, Set> {
+    using Column<Codec, Get, Set>::bind;
+    using Column<Codec, Get, Set>::decode;
+    using Column<Codec, Get, Set>::text;
+    using Column<Codec, Get, Set>::write;
+    using Column<Codec, Get, Set>::isNull;
+    using Column<Codec, Get, Set>::json;
+    static QVariant bind(const ComponentSummary &record) { return Codec::bind(record.*Member); }
+    static void decode(ComponentSummary &record, const QVariant &value) { record.*Member = Codec::decode(value); }
+    static QString text(const ComponentSummary &record) { return Codec::text(record.*Member); }
+    static void write(QTextStream &out, const ComponentSummary &record) { Codec::write(out, record.*Member); }
+    static bool isNull(const ComponentSummary &record) { return Codec::isNull(record.*Member); }
+    static QJsonValue json(const ComponentSummary &record) { return Codec::json(record.*Member); }
+};
+
+/// @brief Columna calculada a partir de otro campo de Component: solo se escribe.
+template <typename Codec, typename Codec::Value (Component::*Get)() const>
+struct DerivedColumn {
+    static QVariant bind(const Component &record) { return Codec::bind((record.*Get)()); }
+};
+
+/// @brief Identificador (clave primaria).
+struct Id : ListColumn<Integer, &Component::id, &Component::setId, &ComponentSummary::id> {
+    static const char *column() { return "id"; }
+    static const char *label() { return "ID"; }
+    static const char *csvLabel() { return "ID"; }
+};
+
+/// @brief Nombre descriptivo.
+struct Name : ListColumn<Text, &Component::name, &Component::setName, &ComponentSummary::name> {
+    static const char *column() { return "name"; }
+    static const char *label() { return "Nombre"; }
+    static const char *csvLabel() { return "Nombre"; }
+};
+
+/// @brief Tipo o categoría.
+struct Type : ListColumn<Text, &Component::type, &Component::setType, &ComponentSummary::type> {
+    static const char *column() { return "type"; }
+    static const char *label() { return "Tipo"; }
+    static const char *csvLabel() { return "Tipo"; }
+};
+
+/// @brief Unidades disponibles.
+struct Quantity : ListColumn<Integer, &Component::quantity, &Component::setQuantity, &ComponentSummary::quantity> {
+    static const char *column() { return "quantity"; }
+    static const char *label() { return "Cantidad"; }
+    static const char *csvLabel() { return "Cantidad"; }
+};
+
+/// @brief Ubicación de almacenamiento.
+struct Location : ListColumn<Text, &Component::location, &Component::setLocation, &ComponentSummary::location> {
+    static const char *column() { return "location"; }
+    static const char *label() { return "Ubicación"; }
+    static const char *csvLabel() { return "Ubicacion"; }
+};
+
+/// @brief Fecha de compra.
+struct PurchaseDate : ListColumn<IsoDate, &Component::purchaseDate, &Component::setPurchaseDate,
+                                 &ComponentSummary::purchaseDate> {
+    static const char *column() { return "purchase_date"; }
+    static const char *label() { return "Fecha Compra"; }
+    static const char *csvLabel() { return "FechaCompra"; }
+};
+
+/// @brief Umbral de reposición propio (NULL si no se define).
+struct ReorderThreshold : Column<OptionalInteger, &Component::reorderThreshold, &Component::setReorderThreshold> {
+    static const char *column() { return "reorder_threshold"; }
+    static const char *label() { return "Umbral"; }
+    static const char *csvLabel() { return "Umbral"; }
+};
+
+/// @brief Notas libres.
+struct Notes : Column<OptionalText, &Component::notes, &Component::setNotes> {
+    static const char *column() { return "notes"; }
+    static const char *label() { return "Notas"; }
+    static const char *csvLabel() { return "Notas"; }
+};
+
+/// @brief URL de la hoja de datos.
+struct DatasheetUrl : Column<OptionalText, &Component::datasheetUrl, &Component::setDatasheetUrl> {
+    static const char *column() { return "datasheet_url"; }
+    static const char *label() { return "Hoja de datos"; }
+    static const char *csvLabel() { return "HojaDatos"; }
+};
+
+/// @brief Código de barras.
+struct Barcode : Column<OptionalText, &Component::barcode, &Component::setBarcode> {
+    static const char *column() { return "barcode"; }
+    static const char *label() { return "Código de barras"; }
+    static const char *csvLabel() { return "CodigoBarras"; }
+};
+
+/// @brief Día de compra como número de día, para filtros de fechas y antigüedad indexados.
+struct PurchaseDay : DerivedColumn<DayNumber, &Component::purchaseDate> {
+    static const char *column() { return "purchase_day"; }
+};
+
+// ---------------------------------------------------------------------------
+// Listas de columnas
+// ---------------------------------------------------------------------------
+
+/// @brief Lista de columnas; las operaciones se expanden columna a columna en compilación.
+///        Los parámetros SQL son posicionales ("?"), en el orden de la lista.
+template <typename... F>
+struct Fields;
+
+/// @brief Caso base: lista vacía.
+template <>
+struct Fields<> {
+    static const int size = 0;
+    template <typename Field> static constexpr int indexOf() { return -1; }
+    static void appendColumns(QString &, const char *, const char *) {}
+    static void appendAssignments(QString &) {}
+    static void appendLabels(QStringList &, bool) {}
+    template <typename Record> static void bind(QSqlQuery &, const Record &, int) {}
+    template <typename Record> static void decode(const QSqlQuery &, Record &, int) {}
+    template <typename Record, typename Visitor> static void forEachText(const Record &, Visitor &, int) {}
+    template <typename Record> static void writeCsv(QTextStream &, const Record &, bool) {}
+    template <typename Record> static void insertJson(QJsonObject &, const Record &) {}
+};
+
+/// @brief Lista con al menos una columna.
+template <typename Head, typename... Tail>
+struct Fields<Head, Tail...> {
+    typedef Fields<Tail...> Rest;
+    static const int size = 1 + Rest::size;
+
+    /// @brief Posición de la columna Field en la lista (-1 si no está), en compilación.
+    template <typename Field>
+    static constexpr int indexOf()
+    {
+        return std::is_same<Field, Head>::value ? 0 : after(Rest::template indexOf<Field>());
+    }
+
+    /// @brief Posición en esta lista de una posición en Rest.
+    static constexpr int after(int restIndex) { return restIndex < 0 ? -1 : restIndex + 1; }
+
+    /// @brief Nombres SQL separados por comas, con prefijo de tabla opcional (p. ej. "c.").
+    static QString columns(const char *prefix = "")
+    {
+        QString list;
+        appendColumns(list, prefix, "");
+        return list;
+    }
+
+    /// @brief Tantos parámetros posicionales como columnas ("?, ?, ...").
+    static QString placeholders()
+    {
+        QString list;
+        for (int i = 0; i < size; ++i)
+            list += i == 0 ? "?" : ", ?";
+        return list;
+    }
+
+    /// @brief Asignaciones para UPDATE ("name = ?, type = ?, ...").
+    static QString assignments()
+    {
+        QString list;
+        appendAssignments(list);
+        return list;
+    }
+
+    /// @brief Etiquetas de las columnas para tablas e informes.
+    /// @param csv true para las etiquetas de la cabecera CSV (sin espacios ni tildes).
+    static QStringList labels(bool csv = false)
+    {
+        QStringList list;
+        appendLabels(list, csv);
+        return list;
+    }
+
+    /// @brief Enlaza los valores del registro a los parámetros posicionales desde `first`.
+    template <typename Record>
+    static void bind(QSqlQuery &query, const Record &record, int first = 0)
+    {
+        query.bindValue(first, Head::bind(record));
+        Rest::bind(query, record, first + 1);
+    }
+
+    /// @brief Lee las columnas de la fila actual, desde la posición `first`, en el registro.
+    template <typename Record>
+    static void decode(const QSqlQuery &query, Record &record, int first = 0)
+    {
+        Head::decode(record, query.value(first));
+        Rest::decode(query, record, first + 1);
+    }
+
+    /// @brief Llama a visitor(columna, texto) con el texto de cada celda del registro.
+    template <typename Record, typename Visitor>
+    static void forEachText(const Record &record, Visitor &visitor, int column = 0)
+    {
+        visitor(column, Head::text(record));
+        Rest::forEachText(record, visitor, column + 1);
+    }
+
+    /// @brief Escribe el registro como línea CSV (sin salto de línea final).
+    template <typename Record>
+    static void writeCsv(QTextStream &out, const Record &record, bool first = true)
+    {
+        if (!first)
+            out << ',';
+        Head::write(out, record);
+        Rest::writeCsv(out, record, false);
+    }
+
+    /// @brief Añade al objeto JSON las columnas del registro, con su nombre SQL; las nulas se omiten.
+    template <typename Record>
+    static void insertJson(QJsonObject &object, const Record &record)
+    {
+        if (!Head::isNull(record))
+            object.insert(Head::column(), Head::json(record));
+        Rest::insertJson(object, record);
+    }
+
+    static void appendColumns(QString &list, const char *prefix, const char *separator)
+    {
+        list += separator;
+        list += prefix;
+        list += Head::column();
+        Rest::appendColumns(list, prefix, ", ");
+    }
+
+    static void appendAssignments(QString &list)
+    {
+        if (!list.isEmpty())
+            list += ", ";
+        list += Head::column();
+        list += " = ?";
+        Rest::appendAssignments(list);
+    }
+
+    static void appendLabels(QStringList &list, bool csv)
+    {
+        list << QString::fromUtf8(csv ? Head::csvLabel() : Head::label());
+        Rest::appendLabels(list, csv);
+    }
+};
+
+/// @brief Concatenación de dos listas de columnas.
+template <typename A, typename B>
+struct Concat;
+
+template <typename... A, typename... B>
+struct Concat<Fields<A...>, Fields<B...>> {
+    typedef Fields<A..., B...> type;
+};
+
+/// @brief Columnas de listado: las de ComponentSummary, en el orden de las tablas.
+typedef Fields<Id, Name, Type, Quantity, Location, PurchaseDate> ListFields;
+
+/// @brief Columnas que se leen y escriben, salvo el ID.
+typedef Fields<Name, Type, Quantity, Location, PurchaseDate, ReorderThreshold, Notes, DatasheetUrl, Barcode>
+    ValueFields;
+
+/// @brief Todas las columnas guardadas, con el ID primero.
+typedef Concat<Fields<Id>, ValueFields>::type StoredFields;
+
+/// @brief Columnas calculadas: se escriben junto a las demás pero no se leen.
+typedef Fields<PurchaseDay> DerivedFields;
+
+/// @brief Columnas de INSERT de filas nuevas y de SET de UPDATE.
+typedef Concat<ValueFields, DerivedFields>::type WrittenFields;
+
+/// @brief Columnas de INSERT de filas con su ID original.
+typedef Concat<StoredFields, DerivedFields>::type RestoredFields;
+
+} // namespace ComponentSchema
+
+#endif // COMPONENTSCHEMA_H
@@ -2,15 +2,192 @@
 /// @brief Implementación de los métodos de la clase DatabaseManager para gestionar la base de datos.
 
 #include "DatabaseManager.h"
+#include "ComponentSchema.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QVariant>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QStringList>
+#include <QTimer>
 #include <QDebug>
+#include <limits>
+
+namespace {
+/// Versión del esquema a partir de la cual purchase_day está rellenado e indexado.
+const int kPurchaseDayVersion = 7;
+
+/// @brief Columna que una migración añade a una tabla existente.
+struct ColumnAddition {
+    const char *table;       ///< Tabla que recibe la columna.
+    const char *column;      ///< Nombre de la columna.
+    const char *definition;  ///< Tipo y restricciones de la columna.
+};
+
+/// @brief Paso de evolución del esquema identificado por su versión (PRAGMA user_version).
+///
+/// columns y statements se aplican de forma síncrona al abrir la base, una sola vez
+/// (ver initializeTables()), y deben ser idempotentes por si dos conexiones las aplican a
+/// la vez en el primer arranque. backfill es una sentencia parametrizada con :lo y :hi que se ejecuta
+/// por lotes de IDs (id > :lo AND id <= :hi) en segundo plano; deferred son sentencias
+/// costosas (p. ej. CREATE INDEX) que se ejecutan en segundo plano tras el relleno.
+struct SchemaMigration {
+    int version;                          ///< Versión que alcanza el esquema.
+    const char *description;              ///< Descripción breve del cambio.
+    std::vector<ColumnAddition> columns;  ///< Columnas añadidas de forma síncrona.
+    QStringList statements;               ///< DDL síncrono e idempotente.
+    QString backfill;                     ///< Relleno por lotes (vacío si no aplica).
+    QStringList deferred;                 ///< Sentencias diferidas a segundo plano.
+
+    /// @brief Indica si la migración tiene trabajo en segundo plano.
+    bool hasBackgroundWork() const { return !backfill.isEmpty() || !deferred.isEmpty(); }
+};
+
+/// @brief Lista ordenada de migraciones del esquema.
+const std::vector<SchemaMigration> &schemaMigrations()
+{
+    static const std::vector<SchemaMigration> migrations = {
+        { 1, "Tabla de componentes", {},
+          { R"(
+            CREATE TABLE IF NOT EXISTS components (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                name TEXT NOT NULL,
+                type TEXT,
+                quantity INTEGER NOT NULL,
+                location TEXT,
+                purchase_date TEXT
+            )
+          )" },
+          QString(), {} },
+        { 2, "Umbrales de reposicion", { { "components", "reorder_threshold", "INTEGER" } },
+          { R"(
+            CREATE TABLE IF NOT EXISTS type_thresholds (
+                type TEXT PRIMARY KEY,
+                threshold INTEGER NOT NULL
+            )
+          )" },
+          QString(), {} },
+        { 3, "Indices de cantidad y tipo", {}, {}, QString(),
+          { "CREATE INDEX IF NOT EXISTS idx_components_quantity ON components(quantity)",
+            "CREATE INDEX IF NOT EXISTS idx_components_type ON components(type)" } },
+        // Los disparadores registran cada escritura; el relleno da de alta las filas previas
+        // que aún no tienen ninguna entrada, de modo que repetirlo tras una interrupción o
+        // sobre filas ya registradas por los disparadores no duplica altas
+        { 4, "Registro de cambios", {},
+          { R"(
+            CREATE TABLE IF NOT EXISTS changes (
+                seq INTEGER PRIMARY KEY AUTOINCREMENT,
+                op TEXT NOT NULL,
+                component_id INTEGER NOT NULL,
+                changed_at TEXT NOT NULL DEFAULT (strftime('%Y-%m-%dT%H:%M:%fZ', 'now'))
+            )
+          )",
+            "CREATE INDEX IF NOT EXISTS idx_changes_component ON changes(component_id)",
+            R"(
+            CREATE TRIGGER IF NOT EXISTS components_changes_insert AFTER INSERT ON components
+            BEGIN
+                INSERT INTO changes (op, component_id) VALUES ('insert', NEW.id);
+            END
+          )",
+            R"(
+            CREATE TRIGGER IF NOT EXISTS components_changes_update
+            AFTER UPDATE OF name, type, quantity, location, purchase_date, reorder_threshold ON components
+            BEGIN
+                INSERT INTO changes (op, component_id) VALUES ('update', NEW.id);
+            END
+          )",
+            R"(
+            CREATE TRIGGER IF NOT EXISTS components_changes_delete AFTER DELETE ON components
+            BEGIN
+                INSERT INTO changes (op, component_id) VALUES ('delete', OLD.id);
+            END
+          )" },
+          "INSERT INTO changes (op, component_id) "
+          "SELECT 'insert', id FROM components WHERE id > :lo AND id <= :hi "
+          "AND NOT EXISTS (SELECT 1 FROM changes WHERE changes.component_id = components.id) ORDER BY id",
+          {} },
+        // Campos de detalle: no se leen en los listados. El disparador de actualizaciones
+        // se recrea para registrar también los cambios de estas columnas.
+        { 5, "Notas y hoja de datos",
+          { { "components", "notes", "TEXT" }, { "components", "datasheet_url", "TEXT" } },
+          { "DROP TRIGGER IF EXISTS components_changes_update",
+            R"(
+            CREATE TRIGGER components_changes_update
+            AFTER UPDATE OF name, type, quantity, location, purchase_date, reorder_threshold,
+                            notes, datasheet_url ON components
+            BEGIN
+                INSERT INTO changes (op, component_id) VALUES ('update', NEW.id);
+            END
+          )" },
+          QString(), {} },
+        // El índice único se crea al abrir: la columna es nueva y está vacía, y los escaneos
+        // necesitan resolver códigos con búsqueda indexada desde el primer momento
+        { 6, "Codigos de barras", { { "components", "barcode", "TEXT" } },
+          { "CREATE UNIQUE INDEX IF NOT EXISTS idx_components_barcode ON components(barcode)",
+            "DROP TRIGGER IF EXISTS components_changes_update",
+            R"(
+            CREATE TRIGGER components_changes_update
+            AFTER UPDATE OF name, type, quantity, location, purchase_date, reorder_threshold,
+                            notes, datasheet_url, barcode ON components
+            BEGIN
+                INSERT INTO changes (op, component_id) VALUES ('update', NEW.id);
+            END
+          )" },
+          QString(), {} },
+        // Número de día de purchase_date para filtros de fechas y antigüedad. Las escrituras
+        // lo rellenan desde la aplicación (ComponentSchema::PurchaseDay); las filas previas se
+        // rellenan por lotes. El índice incluye tipo y cantidad para que los histogramas de
+        // antigüedad recorran el índice sin leer la tabla.
+        { kPurchaseDayVersion, "Dia de compra", { { "components", "purchase_day", "INTEGER" } }, {},
+          "UPDATE components SET purchase_day = CAST(julianday(purchase_date) - 2440587.5 AS INTEGER) "
+          "WHERE id > :lo AND id <= :hi",
+          { "CREATE INDEX IF NOT EXISTS idx_components_purchase_day ON components(purchase_day, type, quantity)" } },
+    };
+    return migrations;
+}
+}
+
+/// @brief Constructor: histograma vacío.
+AgingHistogram::AgingHistogram()
+    : undated(0)
+{}
+
+/// @brief Suma las franjas de otro histograma con los mismos límites.
+/// @param other Histograma a sumar (p. ej. el de otro fragmento).
+void AgingHistogram::add(const AgingHistogram &other)
+{
+    undated += other.undated;
+    for (auto it = other.byType.constBegin(); it != other.byType.constEnd(); ++it) {
+        std::vector<AgingBucket> &buckets = byType[it.key()];
+        buckets.resize(bounds.size() + 1, AgingBucket());
+        for (std::size_t i = 0; i < buckets.size() && i < it.value().size(); ++i) {
+            buckets[i].components += it.value()[i].components;
+            buckets[i].units += it.value()[i].units;
+        }
+    }
+}
+
+/// @brief Etiqueta de una franja de antigüedad en días.
+/// @param index Índice de la franja (0 a bounds.size()).
+/// @return Texto "desde-hasta", o ">límite" en la última franja.
+QString AgingHistogram::bucketLabel(std::size_t index) const
+{
+    if (index >= bounds.size())
+        return bounds.empty() ? QString(">=0") : QString(">%1").arg(bounds.back());
+    const int low = index == 0 ? 0 : bounds[index - 1] + 1;
+    return QString("%1-%2").arg(low).arg(bounds[index]);
+}
 
 /// @brief Constructor de DatabaseManager.
 /// @param parent Objeto padre en la jerarquía de Qt (por defecto nullptr).
 DatabaseManager::DatabaseManager(QObject *parent)
     : QObject(parent)
+    , m_migrationBatchSize(5000)
+    , m_backfillCursor(0)
+    , m_backfillStart(0)
+    , m_backfillMaxId(-1)
+    , m_deferredIndex(0)
+    , m_schemaVersion(-1)
 {}
 
 /// @brief Destructor de DatabaseManager.
@@ -21,21 +198,33 @@ DatabaseManager::~DatabaseManager()
 }
 
 /// @brief Abre (o reutiliza) la conexión a la base de datos SQLite.
+///        La conexión usa modo WAL y espera hasta 5 s cuando otra conexión tiene el bloqueo
+///        de escritura, de modo que varios hilos o procesos pueden compartir el archivo.
 /// @param path Ruta al archivo de la base de datos.
+/// @param connectionName Nombre de la conexión Qt; cada hilo debe usar uno propio.
 /// @return true si la conexión se establece correctamente; false en caso de error.
-bool DatabaseManager::openDatabase(const QString &path)
+bool DatabaseManager::openDatabase(const QString &path, const QString &connectionName)
 {
-    if (QSqlDatabase::contains("qt_inventory_connection")) {
-        m_db = QSqlDatabase::database("qt_inventory_connection");
+    if (QSqlDatabase::contains(connectionName)) {
+        m_db = QSqlDatabase::database(connectionName);
     } else {
-        m_db = QSqlDatabase::addDatabase("QSQLITE", "qt_inventory_connection");
+        m_db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
         m_db.setDatabaseName(path);
+        m_db.setConnectOptions("QSQLITE_BUSY_TIMEOUT=5000");
     }
 
+    m_schemaVersion = -1;
     if (!m_db.open()) {
         qDebug() << "Error al abrir DB:" << m_db.lastError().text();
         return false;
     }
+    QSqlQuery query(m_db);
+    // Solo surte efecto en archivos nuevos; los existentes cambian de modo en su primer
+    // mantenimiento (ver runMaintenance())
+    if (!query.exec("PRAGMA auto_vacuum = INCREMENTAL"))
+        qDebug() << "No se pudo activar la compactación incremental:" << query.lastError().text();
+    if (!query.exec("PRAGMA journal_mode=WAL"))
+        qDebug() << "No se pudo activar WAL:" << query.lastError().text();
     return true;
 }
 
@@ -46,48 +235,326 @@ void DatabaseManager::closeDatabase()
         m_db.close();
     }
 }
-/// @brief Crea las tablas necesarias en la base de datos si no existen.
-/// @return true si la tabla se crea o ya existía sin errores; false en caso contrario.
+/// @brief Aplica la parte síncrona de las migraciones pendientes del esquema.
+///
+/// La versión del esquema se guarda en PRAGMA user_version. Las columnas y sentencias
+/// DDL de cada migración pendiente se aplican en una transacción (son operaciones de
+/// coste constante); los rellenos por lotes y los índices diferidos quedan pendientes
+/// para startBackgroundMigrations(). user_version solo avanza hasta la última versión
+/// completamente aplicada, por lo que un arranque interrumpido retoma el trabajo.
+///
+/// La parte síncrona aplicada se registra aparte, en la tabla schema_ddl, para no
+/// repetir el DDL (p. ej. recrear disparadores) en cada apertura mientras el trabajo en
+/// segundo plano sigue en curso, ni bloquear con él a las conexiones que lo ejecutan.
+/// @return true si el esquema queda utilizable; false en caso de error.
 bool DatabaseManager::initializeTables()
+{
+    const std::vector<SchemaMigration> &migrations = schemaMigrations();
+    m_schemaVersion = -1;
+    const int current = schemaVersion();
+    if (current > latestSchemaVersion())
+        qDebug() << "Esquema más reciente que la aplicación:" << current;
+
+    m_pendingMigrations.clear();
+    for (std::size_t i = 0; i < migrations.size(); ++i) {
+        if (migrations[i].version > current && migrations[i].hasBackgroundWork())
+            m_pendingMigrations.push_back(i);
+    }
+    // Las versiones sin trabajo en segundo plano se consideran completas
+    const int completed = m_pendingMigrations.empty()
+                              ? latestSchemaVersion()
+                              : migrations[m_pendingMigrations.front()].version - 1;
+
+    // Sin la tabla schema_ddl (bases anteriores), el DDL aplicado es el de user_version
+    QSqlQuery query(m_db);
+    int applied = current;
+    if (query.exec("SELECT COALESCE(MAX(version), 0) FROM schema_ddl") && query.next())
+        applied = qMax(applied, query.value(0).toInt());
+    query.finish();
+    if (applied >= latestSchemaVersion() && completed <= current)
+        return true;
+
+    if (!m_db.transaction()) {
+        qDebug() << "Error al iniciar migración:" << m_db.lastError().text();
+        return false;
+    }
+    if (!query.exec("CREATE TABLE IF NOT EXISTS schema_ddl (version INTEGER PRIMARY KEY)")) {
+        qDebug() << "Error al crear el registro de migraciones:" << query.lastError().text();
+        m_db.rollback();
+        return false;
+    }
+    for (const SchemaMigration &migration : migrations) {
+        if (migration.version <= applied)
+            continue;
+        for (const ColumnAddition &column : migration.columns) {
+            if (!ensureColumn(column.table, column.column, column.definition)) {
+                m_db.rollback();
+                return false;
+            }
+        }
+        for (const QString &statement : migration.statements) {
+            if (!query.exec(statement)) {
+                qDebug() << "Error en migración" << migration.version << ":" << query.lastError().text();
+                m_db.rollback();
+                return false;
+            }
+        }
+        query.prepare("INSERT OR IGNORE INTO schema_ddl (version) VALUES (:version)");
+        query.bindValue(":version", migration.version);
+        if (!query.exec()) {
+            qDebug() << "Error al registrar migración" << migration.version << ":" << query.lastError().text();
+            m_db.rollback();
+            return false;
+        }
+    }
+
+    if (completed > current && !setSchemaVersion(completed)) {
+        m_db.rollback();
+        return false;
+    }
+    if (!m_db.commit()) {
+        qDebug() << "Error al confirmar migración:" << m_db.lastError().text();
+        m_db.rollback();
+        m_schemaVersion = -1;
+        return false;
+    }
+    return true;
+}
+
+/// @brief Versión del esquema almacenada en la base de datos.
+///        Una vez completas las migraciones no cambia, así que no se vuelve a leer; antes,
+///        la lectura se limita a una por segundo.
+/// @return Valor de PRAGMA user_version, o 0 si no puede leerse.
+int DatabaseManager::schemaVersion()
+{
+    if (m_schemaVersion >= latestSchemaVersion()
+        || (m_schemaVersion >= 0 && m_schemaVersionAge.isValid() && m_schemaVersionAge.elapsed() < 1000))
+        return m_schemaVersion;
+    QSqlQuery query(m_db);
+    if (!query.exec("PRAGMA user_version") || !query.next())
+        return 0;
+    m_schemaVersion = query.value(0).toInt();
+    m_schemaVersionAge.start();
+    return m_schemaVersion;
+}
+
+/// @brief Versión del esquema que produce la última migración conocida.
+/// @return Número de versión más alto de la lista de migraciones.
+int DatabaseManager::latestSchemaVersion()
+{
+    return schemaMigrations().back().version;
+}
+
+/// @brief Indica si quedan migraciones con trabajo en segundo plano.
+/// @return true si hay rellenos o índices diferidos pendientes.
+bool DatabaseManager::hasPendingMigrations() const
+{
+    return !m_pendingMigrations.empty();
+}
+
+/// @brief Inicia el trabajo en segundo plano de las migraciones pendientes.
+///        Cada lote se ejecuta en una vuelta del bucle de eventos para no bloquear la aplicación.
+/// @param batchSize Número de IDs procesados por lote de relleno.
+void DatabaseManager::startBackgroundMigrations(int batchSize)
+{
+    m_migrationBatchSize = batchSize < 1 ? 1 : batchSize;
+    m_backfillCursor = 0;
+    m_backfillMaxId = -1;
+    m_deferredIndex = 0;
+    QTimer::singleShot(0, this, &DatabaseManager::runMigrationStep);
+}
+
+/// @brief Ejecuta un paso (un lote de relleno o una sentencia diferida) de la migración en curso.
+void DatabaseManager::runMigrationStep()
+{
+    if (m_pendingMigrations.empty()) {
+        emit migrationsFinished(true);
+        return;
+    }
+
+    const std::vector<SchemaMigration> &migrations = schemaMigrations();
+    const SchemaMigration &migration = migrations[m_pendingMigrations.front()];
+    QSqlQuery query(m_db);
+
+    if (!migration.backfill.isEmpty() && (m_backfillMaxId < 0 || m_backfillCursor < m_backfillMaxId)) {
+        if (m_backfillMaxId < 0) {
+            // El cursor parte del primer ID existente: los fragmentos usan rangos de IDs que
+            // empiezan en k * 2^24 y recorrer los lotes vacíos hasta ahí costaría miles de pasos
+            if (!query.exec("SELECT COALESCE(MIN(id) - 1, 0), COALESCE(MAX(id), 0) FROM components")
+                || !query.next()) {
+                qDebug() << "Error al preparar relleno:" << query.lastError().text();
+                m_pendingMigrations.clear();
+                emit migrationsFinished(false);
+                return;
+            }
+            m_backfillStart = query.value(0).toLongLong();
+            m_backfillCursor = m_backfillStart;
+            m_backfillMaxId = query.value(1).toLongLong();
+        }
+        if (m_backfillCursor < m_backfillMaxId) {
+            const qint64 high = qMin(m_backfillCursor + m_migrationBatchSize, m_backfillMaxId);
+            query.prepare(migration.backfill);
+            query.bindValue(":lo", m_backfillCursor);
+            query.bindValue(":hi", high);
+            if (!query.exec()) {
+                qDebug() << "Error en relleno de migración" << migration.version << ":" << query.lastError().text();
+                m_pendingMigrations.clear();
+                emit migrationsFinished(false);
+                return;
+            }
+            m_backfillCursor = high;
+            emit migrationProgress(migration.version, m_backfillCursor - m_backfillStart,
+                                   m_backfillMaxId - m_backfillStart);
+            QTimer::singleShot(0, this, &DatabaseManager::runMigrationStep);
+            return;
+        }
+    }
+
+    if (m_deferredIndex < migration.deferred.size()) {
+        if (!query.exec(migration.deferred.at(m_deferredIndex))) {
+            qDebug() << "Error en migración diferida" << migration.version << ":" << query.lastError().text();
+            m_pendingMigrations.clear();
+            emit migrationsFinished(false);
+            return;
+        }
+        ++m_deferredIndex;
+        emit migrationProgress(migration.version, m_deferredIndex, migration.deferred.size());
+        QTimer::singleShot(0, this, &DatabaseManager::runMigrationStep);
+        return;
+    }
+
+    // Migración completa: se avanza la versión hasta la siguiente con trabajo pendiente
+    m_pendingMigrations.erase(m_pendingMigrations.begin());
+    const int completed = m_pendingMigrations.empty()
+                              ? latestSchemaVersion()
+                              : migrations[m_pendingMigrations.front()].version - 1;
+    setSchemaVersion(completed);
+    m_backfillCursor = 0;
+    m_backfillMaxId = -1;
+    m_deferredIndex = 0;
+    QTimer::singleShot(0, this, &DatabaseManager::runMigrationStep);
+}
+
+/// @brief Expresión SQL del día de compra.
+///        user_version solo alcanza kPurchaseDayVersion cuando el relleno y el índice de
+///        purchase_day han terminado; hasta entonces se calcula desde purchase_date.
+/// @return Expresión para usar en WHERE, ORDER BY o CASE.
+QString DatabaseManager::purchaseDayExpression()
+{
+    return schemaVersion() >= kPurchaseDayVersion ? QString("purchase_day")
+                                                  : QString("CAST(julianday(purchase_date) - 2440587.5 AS INTEGER)");
+}
+
+/// @brief Lee el valor entero de un PRAGMA sin argumentos.
+/// @param pragma Nombre del PRAGMA.
+/// @return Valor leído, o -1 en caso de error.
+qint64 DatabaseManager::pragmaValue(const QString &pragma)
 {
     QSqlQuery query(m_db);
-    QString createTable = R"(
-        CREATE TABLE IF NOT EXISTS components (
-            id INTEGER PRIMARY KEY AUTOINCREMENT,
-            name TEXT NOT NULL,
-            type TEXT,
-            quantity INTEGER NOT NULL,
-            location TEXT,
-            purchase_date TEXT
-        )
-    )";
-    if (!query.exec(createTable)) {
-        qDebug() << "Error al crear tabla:" << query.lastError().text();
+    if (!query.exec(QString("PRAGMA %1").arg(pragma)) || !query.next()) {
+        qDebug() << "Error al leer PRAGMA" << pragma << ":" << query.lastError().text();
+        return -1;
+    }
+    return query.value(0).toLongLong();
+}
+
+/// @brief Guarda la versión del esquema en PRAGMA user_version.
+/// @param version Versión a guardar.
+/// @return true si se guarda correctamente; false en caso de error.
+bool DatabaseManager::setSchemaVersion(int version)
+{
+    QSqlQuery query(m_db);
+    if (!query.exec(QString("PRAGMA user_version = %1").arg(version))) {
+        qDebug() << "Error al guardar versión del esquema:" << query.lastError().text();
+        return false;
+    }
+    m_schemaVersion = version;
+    m_schemaVersionAge.start();
+    return true;
+}
+
+/// @brief Añade una columna a una tabla si no existe todavía.
+/// @param table Nombre de la tabla.
+/// @param column Nombre de la columna buscada.
+/// @param definition Tipo y restricciones con los que se crea la columna.
+/// @return true si la columna ya existía o se añade sin errores; false en caso contrario.
+bool DatabaseManager::ensureColumn(const QString &table, const QString &column, const QString &definition)
+{
+    QSqlQuery query(m_db);
+    if (!query.exec(QString("PRAGMA table_info(%1)").arg(table))) {
+        qDebug() << "Error al leer columnas:" << query.lastError().text();
+        return false;
+    }
+    while (query.next()) {
+        if (query.value(1).toString() == column)
+            return true;
+    }
+    if (!query.exec(QString("ALTER TABLE %1 ADD COLUMN %2 %3").arg(table, column, definition))) {
+        qDebug() << "Error al añadir columna:" << query.lastError().text();
         return false;
     }
     return true;
 }
 
+/// @brief Construye un Component con todas las columnas de la fila actual.
+/// @param query Consulta posicionada en una fila con las columnas de ComponentSchema::StoredFields.
+/// @param first Posición de la columna id en la consulta.
+/// @return Componente con los valores leídos.
+Component DatabaseManager::readComponent(const QSqlQuery &query, int first)
+{
+    Component component;
+    ComponentSchema::StoredFields::decode(query, component, first);
+    return component;
+}
+
+/// @brief Construye un ComponentSummary con las columnas de listado de la fila actual.
+/// @param query Consulta posicionada en una fila con las columnas de ComponentSchema::ListFields.
+/// @return Resumen con los valores leídos.
+ComponentSummary DatabaseManager::readSummary(const QSqlQuery &query)
+{
+    ComponentSummary summary;
+    ComponentSchema::ListFields::decode(query, summary);
+    return summary;
+}
+
 /// @brief Inserta un nuevo componente en la tabla `components`.
 /// @param component Objeto Component con los datos a almacenar.
+/// @param newId Si no es nullptr, recibe el ID asignado por SQLite.
 /// @return true si la inserción se realiza correctamente; false en caso de error.
-bool DatabaseManager::addComponent(const Component &component)
+bool DatabaseManager::addComponent(const Component &component, int *newId)
 {
+    typedef ComponentSchema::WrittenFields Fields;
+    static const QString sql = QString("INSERT INTO components (%1) VALUES (%2)")
+                                   .arg(Fields::columns(), Fields::placeholders());
     QSqlQuery query(m_db);
-    query.prepare(R"(
-        INSERT INTO components (name, type, quantity, location, purchase_date)
-        VALUES (:name, :type, :quantity, :location, :purchase_date)
-    )");
-    query.bindValue(":name", component.name());
-    query.bindValue(":type", component.type());
-    query.bindValue(":quantity", component.quantity());
-    query.bindValue(":location", component.location());
-    query.bindValue(":purchase_date", component.purchaseDate().toString(Qt::ISODate));
+    query.prepare(sql);
+    Fields::bind(query, component);
 
     if (!query.exec()) {
         qDebug() << "Error al insertar componente:" << query.lastError().text();
         return false;
     }
+    if (newId)
+        *newId = query.lastInsertId().toInt();
+    return true;
+}
+
+/// @brief Reinserta un componente con su ID original.
+/// @param component Objeto Component con el ID a conservar y sus datos.
+/// @return true si la inserción se realiza correctamente; false en caso de error (p. ej. ID ocupado).
+bool DatabaseManager::restoreComponent(const Component &component)
+{
+    typedef ComponentSchema::RestoredFields Fields;
+    static const QString sql = QString("INSERT INTO components (%1) VALUES (%2)")
+                                   .arg(Fields::columns(), Fields::placeholders());
+    QSqlQuery query(m_db);
+    query.prepare(sql);
+    Fields::bind(query, component);
+
+    if (!query.exec()) {
+        qDebug() << "Error al restaurar componente:" << query.lastError().text();
+        return false;
+    }
     return true;
 }
 
@@ -96,22 +563,12 @@ bool DatabaseManager::addComponent(const Component &component)
 /// @return true si la actualización se realiza correctamente; false en caso de error.
 bool DatabaseManager::updateComponent(const Component &component)
 {
+    typedef ComponentSchema::WrittenFields Fields;
+    static const QString sql = QString("UPDATE components SET %1 WHERE id = ?").arg(Fields::assignments());
     QSqlQuery query(m_db);
-    query.prepare(R"(
-        UPDATE components
-        SET name = :name,
-            type = :type,
-            quantity = :quantity,
-            location = :location,
-            purchase_date = :purchase_date
-        WHERE id = :id
-    )");
-    query.bindValue(":id", component.id());
-    query.bindValue(":name", component.name());
-    query.bindValue(":type", component.type());
-    query.bindValue(":quantity", component.quantity());
-    query.bindValue(":location", component.location());
-    query.bindValue(":purchase_date", component.purchaseDate().toString(Qt::ISODate));
+    query.prepare(sql);
+    Fields::bind(query, component);
+    query.bindValue(Fields::size, component.id());
 
     if (!query.exec()) {
         qDebug() << "Error al actualizar componente:" << query.lastError().text();
@@ -135,56 +592,512 @@ bool DatabaseManager::removeComponent(int id)
     return true;
 }
 
+/// @brief Suma (o resta) unidades a la cantidad de un componente de forma atómica.
+/// @param id Identificador del componente.
+/// @param delta Unidades a sumar; negativo para restar.
+/// @return true si el componente existe y se actualiza; false en caso contrario.
+bool DatabaseManager::adjustQuantity(int id, int delta)
+{
+    QSqlQuery query(m_db);
+    query.prepare("UPDATE components SET quantity = quantity + :delta WHERE id = :id");
+    query.bindValue(":delta", delta);
+    query.bindValue(":id", id);
+    if (!query.exec()) {
+        qDebug() << "Error al ajustar cantidad:" << query.lastError().text();
+        return false;
+    }
+    return query.numRowsAffected() > 0;
+}
+
 /// @brief Recupera todos los componentes almacenados en la base de datos.
-/// @return Vector de Component con todos los registros obtenidos; vector vacío en caso de error.
-std::vector<Component> DatabaseManager::fetchAllComponents()
+/// @param limit Número máximo de filas (negativo sin límite).
+/// @return Resúmenes de todos los registros obtenidos; vector vacío en caso de error.
+std::vector<ComponentSummary> DatabaseManager::fetchAllComponents(int limit)
 {
-    std::vector<Component> list;
+    std::vector<ComponentSummary> list;
     QSqlQuery query(m_db);
-    if (!query.exec("SELECT id, name, type, quantity, location, purchase_date FROM components")) {
+    query.setForwardOnly(true);
+    static const QString sql = QString("SELECT %1 FROM components LIMIT :limit")
+                                   .arg(ComponentSchema::ListFields::columns());
+    query.prepare(sql);
+    query.bindValue(":limit", limit < 0 ? -1 : limit);
+    if (!query.exec()) {
         qDebug() << "Error al obtener componentes:" << query.lastError().text();
         return list;
     }
     while (query.next()) {
-        int id = query.value(0).toInt();
-        QString name = query.value(1).toString();
-        QString type = query.value(2).toString();
-        int quantity = query.value(3).toInt();
-        QString location = query.value(4).toString();
-        QDate date = QDate::fromString(query.value(5).toString(), Qt::ISODate);
-        list.emplace_back(id, name, type, quantity, location, date);
+        list.push_back(readSummary(query));
     }
     return list;
 }
 
+/// @brief Recorre todos los componentes con un cursor de solo avance.
+/// @param visitor Función llamada con cada fila; devolver false detiene el recorrido.
+/// @return true si la consulta se ejecuta; false en caso de error.
+bool DatabaseManager::forEachComponent(const std::function<bool(const Component &)> &visitor)
+{
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    static const QString sql = QString("SELECT %1 FROM components").arg(ComponentSchema::StoredFields::columns());
+    if (!query.exec(sql)) {
+        qDebug() << "Error al recorrer componentes:" << query.lastError().text();
+        return false;
+    }
+    while (query.next()) {
+        if (!visitor(readComponent(query)))
+            break;
+    }
+    return true;
+}
+
 /// @brief Busca componentes cuyo nombre, tipo o ubicación coincida con la palabra clave.
 /// @param keyword Cadena utilizada para el filtro de búsqueda (se envuelve en '%').
-/// @return Vector de Component que coinciden con la búsqueda; vector vacío en caso de error.
-std::vector<Component> DatabaseManager::searchComponents(const QString &keyword)
+/// @param limit Número máximo de filas (negativo sin límite).
+/// @return Resúmenes de los componentes que coinciden con la búsqueda; vector vacío en caso de error.
+std::vector<ComponentSummary> DatabaseManager::searchComponents(const QString &keyword, int limit)
 {
-    std::vector<Component> list;
+    std::vector<ComponentSummary> list;
     QSqlQuery query(m_db);
-    query.prepare(R"(
-        SELECT id, name, type, quantity, location, purchase_date
+    query.setForwardOnly(true);
+    static const QString sql = QString(R"(
+        SELECT %1
         FROM components
         WHERE name LIKE :kw OR type LIKE :kw OR location LIKE :kw
-    )");
+        LIMIT :limit
+    )").arg(ComponentSchema::ListFields::columns());
+    query.prepare(sql);
     QString pattern = "%" + keyword + "%";
     query.bindValue(":kw", pattern);
+    query.bindValue(":limit", limit < 0 ? -1 : limit);
     if (!query.exec()) {
         qDebug() << "Error en búsqueda:" << query.lastError().text();
         return list;
     }
     while (query.next()) {
-        int id = query.value(0).toInt();
-        QString name = query.value(1).toString();
-        QString type = query.value(2).toString();
-        int quantity = query.value(3).toInt();
-        QString location = query.value(4).toString();
-        QDate date = QDate::fromString(query.value(5).toString(), Qt::ISODate);
-        list.emplace_back(id, name, type, quantity, location, date);
+        list.push_back(readSummary(query));
+    }
+    return list;
+}
+
+/// @brief Recupera un componente por su ID.
+/// @param id Identificador del componente.
+/// @param component Objeto que recibe los datos si la fila existe.
+/// @return true si se encuentra el componente; false si no existe o hay un error.
+bool DatabaseManager::fetchComponent(int id, Component &component)
+{
+    QSqlQuery query(m_db);
+    static const QString sql = QString("SELECT %1 FROM components WHERE id = :id")
+                                   .arg(ComponentSchema::StoredFields::columns());
+    query.prepare(sql);
+    query.bindValue(":id", id);
+    if (!query.exec()) {
+        qDebug() << "Error al obtener componente:" << query.lastError().text();
+        return false;
+    }
+    if (!query.next())
+        return false;
+    component = readComponent(query);
+    return true;
+}
+
+/// @brief Resuelve un código de barras con el índice único de la columna barcode.
+/// @param barcode Código leído.
+/// @param id Recibe el ID del componente si el código existe.
+/// @return true si el código está asignado; false si no existe o hay un error.
+bool DatabaseManager::fetchComponentIdByBarcode(const QString &barcode, int &id)
+{
+    QSqlQuery query(m_db);
+    query.prepare("SELECT id FROM components WHERE barcode = :barcode");
+    query.bindValue(":barcode", barcode);
+    if (!query.exec()) {
+        qDebug() << "Error al buscar código de barras:" << query.lastError().text();
+        return false;
+    }
+    if (!query.next())
+        return false;
+    id = query.value(0).toInt();
+    return true;
+}
+
+/// @brief Recupera los componentes cuya cantidad no supera su umbral efectivo.
+///        El umbral efectivo es el propio del componente, el de su tipo o el general.
+/// @param defaultThreshold Umbral general.
+/// @param limit Número máximo de filas (negativo sin límite).
+/// @return Resúmenes de los componentes con bajo stock; vector vacío en caso de error.
+std::vector<ComponentSummary> DatabaseManager::fetchLowStockComponents(int defaultThreshold, int limit)
+{
+    std::vector<ComponentSummary> list;
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    static const QString sql = QString(R"(
+        SELECT %1
+        FROM components c
+        LEFT JOIN type_thresholds t ON t.type = c.type
+        WHERE c.quantity <= COALESCE(c.reorder_threshold, t.threshold, :default)
+        LIMIT :limit
+    )").arg(ComponentSchema::ListFields::columns("c."));
+    query.prepare(sql);
+    query.bindValue(":default", defaultThreshold);
+    query.bindValue(":limit", limit < 0 ? -1 : limit);
+    if (!query.exec()) {
+        qDebug() << "Error al obtener bajo stock:" << query.lastError().text();
+        return list;
+    }
+    while (query.next()) {
+        list.push_back(readSummary(query));
+    }
+    return list;
+}
+
+/// @brief Recupera los componentes comprados entre dos fechas, ordenados por fecha de compra.
+///        Con la migración del día de compra completa, el filtro recorre solo el tramo del
+///        índice de purchase_day; antes se calcula el día fila a fila.
+/// @param from Primera fecha incluida (no válida: sin límite inferior).
+/// @param to Última fecha incluida (no válida: sin límite superior).
+/// @param type Tipo exigido (vacío: cualquiera).
+/// @param limit Número máximo de filas (negativo sin límite).
+/// @return Resúmenes de los componentes del intervalo; vector vacío en caso de error.
+std::vector<ComponentSummary> DatabaseManager::fetchComponentsPurchasedBetween(const QDate &from, const QDate &to,
+                                                                               const QString &type, int limit)
+{
+    std::vector<ComponentSummary> list;
+    const QString day = purchaseDayExpression();
+    QString sql = QString("SELECT %1 FROM components WHERE %2 BETWEEN :from AND :to")
+                      .arg(ComponentSchema::ListFields::columns(), day);
+    if (!type.isEmpty())
+        sql += " AND type = :type";
+    sql += QString(" ORDER BY %1, id LIMIT :limit").arg(day);
+
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    query.prepare(sql);
+    query.bindValue(":from", from.isValid() ? ComponentSchema::DayNumber::day(from)
+                                            : std::numeric_limits<qint64>::min());
+    query.bindValue(":to", to.isValid() ? ComponentSchema::DayNumber::day(to)
+                                        : std::numeric_limits<qint64>::max());
+    if (!type.isEmpty())
+        query.bindValue(":type", type);
+    query.bindValue(":limit", limit < 0 ? -1 : limit);
+    if (!query.exec()) {
+        qDebug() << "Error al filtrar por fecha de compra:" << query.lastError().text();
+        return list;
+    }
+    while (query.next()) {
+        list.push_back(readSummary(query));
     }
     return list;
 }
 
+/// @brief Cuenta componentes y unidades por tipo y franja de antigüedad en una sola consulta.
+///        La franja se calcula en SQL con un CASE sobre el día de compra, de modo que solo
+///        vuelve una fila por tipo y franja. Con el índice (purchase_day, type, quantity) la
+///        consulta no lee la tabla, pero recorre el índice entero: su coste es lineal en el
+///        número de componentes. Los filtros por intervalo, en cambio, solo leen su tramo.
+/// @param histogram Histograma con today y bounds fijados; recibe las sumas.
+/// @return true si la consulta se ejecuta; false en caso de error.
+bool DatabaseManager::accumulateAgingHistogram(AgingHistogram &histogram)
+{
+    const QString day = purchaseDayExpression();
+    const qint64 today = ComponentSchema::DayNumber::day(histogram.today);
+    const int lastBucket = int(histogram.bounds.size());
+    QString bucket = QString("CASE WHEN %1 IS NULL THEN -1").arg(day);
+    for (int i = 0; i < lastBucket; ++i)
+        bucket += QString(" WHEN %1 >= %2 THEN %3").arg(day).arg(today - histogram.bounds[std::size_t(i)]).arg(i);
+    bucket += QString(" ELSE %1 END").arg(lastBucket);
+
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    if (!query.exec(QString("SELECT type, %1 AS bucket, COUNT(*), SUM(quantity) FROM components"
+                            " GROUP BY type, bucket").arg(bucket))) {
+        qDebug() << "Error al calcular la antigüedad:" << query.lastError().text();
+        return false;
+    }
+    while (query.next()) {
+        const int index = query.value(1).toInt();
+        if (index < 0) {
+            histogram.undated += query.value(2).toLongLong();
+            continue;
+        }
+        std::vector<AgingBucket> &buckets = histogram.byType[query.value(0).toString()];
+        buckets.resize(std::size_t(lastBucket) + 1, AgingBucket());
+        buckets[std::size_t(index)].components += query.value(2).toLongLong();
+        buckets[std::size_t(index)].units += query.value(3).toLongLong();
+    }
+    return true;
+}
+
+/// @brief Guarda o elimina el umbral de reposición de un tipo.
+/// @param type Tipo de componente.
+/// @param threshold Umbral; si es negativo se elimina el registro del tipo.
+/// @return true si la operación tiene éxito; false en caso de error.
+bool DatabaseManager::setTypeThreshold(const QString &type, int threshold)
+{
+    QSqlQuery query(m_db);
+    if (threshold < 0) {
+        query.prepare("DELETE FROM type_thresholds WHERE type = :type");
+    } else {
+        query.prepare("INSERT OR REPLACE INTO type_thresholds (type, threshold) VALUES (:type, :threshold)");
+        query.bindValue(":threshold", threshold);
+    }
+    query.bindValue(":type", type);
+    if (!query.exec()) {
+        qDebug() << "Error al guardar umbral de tipo:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+/// @brief Recupera los umbrales de reposición definidos por tipo.
+/// @return Tabla tipo → umbral; vacía en caso de error.
+QHash<QString, int> DatabaseManager::fetchTypeThresholds()
+{
+    QHash<QString, int> thresholds;
+    QSqlQuery query(m_db);
+    if (!query.exec("SELECT type, threshold FROM type_thresholds")) {
+        qDebug() << "Error al obtener umbrales de tipo:" << query.lastError().text();
+        return thresholds;
+    }
+    while (query.next()) {
+        thresholds.insert(query.value(0).toString(), query.value(1).toInt());
+    }
+    return thresholds;
+}
+
+/// @brief Recorre en orden de secuencia los cambios registrados después de `since`.
+///        Cada entrada se une con el estado actual de la fila, de modo que el coste es
+///        proporcional al número de cambios y no al tamaño de la tabla.
+/// @param since Secuencia del último cambio ya procesado (0 para empezar desde el principio).
+/// @param visitor Función llamada con cada cambio; devolver false detiene el recorrido.
+/// @param limit Número máximo de cambios a entregar; negativo sin límite.
+/// @return true si la consulta se ejecuta; false en caso de error.
+bool DatabaseManager::forEachChangeSince(qint64 since, const std::function<bool(const ChangeRecord &)> &visitor,
+                                         int limit)
+{
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    static const QString sql = QString(R"(
+        SELECT ch.seq, ch.op, ch.component_id, ch.changed_at, %1
+        FROM changes ch
+        LEFT JOIN components c ON c.id = ch.component_id
+        WHERE ch.seq > :since
+        ORDER BY ch.seq
+        LIMIT :limit
+    )").arg(ComponentSchema::StoredFields::columns("c."));
+    query.prepare(sql);
+    query.bindValue(":since", since);
+    query.bindValue(":limit", limit < 0 ? -1 : limit);
+    if (!query.exec()) {
+        qDebug() << "Error al leer cambios:" << query.lastError().text();
+        return false;
+    }
+    while (query.next()) {
+        ChangeRecord change;
+        change.sequence = query.value(0).toLongLong();
+        const QString op = query.value(1).toString();
+        change.operation = op == "insert" ? ChangeRecord::Insert
+                           : op == "delete" ? ChangeRecord::Delete
+                                            : ChangeRecord::Update;
+        change.componentId = query.value(2).toInt();
+        change.changedAt = query.value(3).toString();
+        change.exists = !query.value(4).isNull();
+        if (change.exists)
+            change.component = readComponent(query, 4);
+        if (!visitor(change))
+            break;
+    }
+    return true;
+}
+
+/// @brief Devuelve la secuencia del último cambio registrado.
+/// @return Secuencia más alta de la tabla de cambios, 0 si está vacía o -1 en caso de error.
+qint64 DatabaseManager::latestChangeSequence()
+{
+    QSqlQuery query(m_db);
+    if (!query.exec("SELECT COALESCE(MAX(seq), 0) FROM changes") || !query.next()) {
+        qDebug() << "Error al leer la secuencia de cambios:" << query.lastError().text();
+        return -1;
+    }
+    return query.value(0).toLongLong();
+}
+
+/// @brief Elimina los cambios ya consumidos por todos los destinatarios.
+///        Las secuencias nunca se reutilizan (AUTOINCREMENT), aunque se poden entradas.
+/// @param upToSequence Última secuencia a eliminar (incluida).
+/// @return true si la eliminación se realiza correctamente; false en caso de error.
+bool DatabaseManager::pruneChanges(qint64 upToSequence)
+{
+    QSqlQuery query(m_db);
+    query.prepare("DELETE FROM changes WHERE seq <= :seq");
+    query.bindValue(":seq", upToSequence);
+    if (!query.exec()) {
+        qDebug() << "Error al podar cambios:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+/// @brief Reserva un rango de IDs para las filas de esta base de datos.
+///        Comprueba que las filas existentes están dentro del rango y adelanta la secuencia
+///        de AUTOINCREMENT hasta su inicio, de modo que los IDs nuevos caen en el rango.
+/// @param first Primer ID del rango.
+/// @param last Último ID del rango.
+/// @return true si las filas existentes están en el rango y la secuencia se ajusta; false en caso contrario.
+bool DatabaseManager::reserveIdRange(qint64 first, qint64 last)
+{
+    QSqlQuery query(m_db);
+    if (!query.exec("SELECT MIN(id), MAX(id) FROM components") || !query.next()) {
+        qDebug() << "Error al leer el rango de IDs:" << query.lastError().text();
+        return false;
+    }
+    if (!query.value(0).isNull()
+        && (query.value(0).toLongLong() < first || query.value(1).toLongLong() > last)) {
+        qDebug() << "Error: IDs fuera del rango" << first << "-" << last << "en" << m_db.databaseName();
+        return false;
+    }
+
+    query.prepare("UPDATE sqlite_sequence SET seq = :seq WHERE name = 'components' AND seq < :seq");
+    query.bindValue(":seq", first - 1);
+    bool ok = query.exec();
+    if (ok) {
+        query.prepare(R"(
+            INSERT INTO sqlite_sequence (name, seq)
+            SELECT 'components', :seq
+            WHERE NOT EXISTS (SELECT 1 FROM sqlite_sequence WHERE name = 'components')
+        )");
+        query.bindValue(":seq", first - 1);
+        ok = query.exec();
+    }
+    if (!ok) {
+        qDebug() << "Error al reservar el rango de IDs:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+/// @brief Copia la base de datos con VACUUM INTO.
+///        La copia se lee dentro de una única transacción de lectura, así que refleja un
+///        instante consistente; en modo WAL los escritores no se bloquean mientras dura.
+///        Se escribe primero en "<path>.part" y se renombra al terminar, de modo que una
+///        copia interrumpida nunca reemplaza a la anterior. La copia sale ya compactada.
+/// @param path Ruta del archivo de copia.
+/// @return true si la copia se completa; false en caso de error.
+bool DatabaseManager::backupTo(const QString &path)
+{
+    const QString partial = path + ".part";
+    QFile::remove(partial);
+    QSqlQuery query(m_db);
+    query.prepare("VACUUM INTO :path");
+    query.bindValue(":path", partial);
+    if (!query.exec()) {
+        qDebug() << "Error al copiar la base de datos:" << query.lastError().text();
+        QFile::remove(partial);
+        return false;
+    }
+    if (QFile::exists(path) && !QFile::remove(path)) {
+        qDebug() << "Error: no se puede reemplazar la copia" << path;
+        return false;
+    }
+    if (!QFile::rename(partial, path)) {
+        qDebug() << "Error al renombrar la copia:" << partial;
+        return false;
+    }
+    return true;
+}
+
+/// @brief Mantenimiento periódico de la base de datos.
+///
+/// Si el archivo aún no usa auto_vacuum incremental (bases creadas antes de activarlo),
+/// se hace una única vez un VACUUM completo que lo activa; bloquea a los escritores mientras
+/// dura. Después, las páginas libres que dejan las eliminaciones se devuelven al sistema con
+/// PRAGMA incremental_vacuum en pasos cortos, cada uno en su propia transacción, para que
+/// los escritores de otras conexiones puedan intercalarse. Finalmente ANALYZE actualiza las
+/// estadísticas del planificador y el punto de control TRUNCATE vacía el archivo WAL.
+/// @param stats Recibe los tamaños y tiempos.
+/// @param pagesPerStep Páginas liberadas por paso (mínimo 1).
+/// @return true si el mantenimiento se completa; false en caso de error.
+bool DatabaseManager::runMaintenance(MaintenanceStats &stats, int pagesPerStep)
+{
+    const qint64 pageSize = pragmaValue("page_size");
+    stats.bytesBefore = pragmaValue("page_count") * pageSize;
+    stats.freePagesBefore = pragmaValue("freelist_count");
+    stats.fullVacuum = false;
+    stats.vacuumMs = 0;
+    stats.analyzeMs = 0;
+    const qint64 autoVacuum = pragmaValue("auto_vacuum");
+    if (pageSize < 0 || stats.bytesBefore < 0 || stats.freePagesBefore < 0 || autoVacuum < 0)
+        return false;
+
+    QSqlQuery query(m_db);
+    QElapsedTimer timer;
+    timer.start();
+    if (autoVacuum != 2) {
+        if (!query.exec("PRAGMA auto_vacuum = INCREMENTAL") || !query.exec("VACUUM")) {
+            qDebug() << "Error al compactar la base de datos:" << query.lastError().text();
+            return false;
+        }
+        stats.fullVacuum = true;
+    } else {
+        qint64 freePages = stats.freePagesBefore;
+        while (freePages > 0) {
+            // Cada página liberada es una fila del resultado: hay que recorrerlo entero
+            if (!query.exec(QString("PRAGMA incremental_vacuum(%1)").arg(qMax(1, pagesPerStep)))) {
+                qDebug() << "Error al compactar la base de datos:" << query.lastError().text();
+                return false;
+            }
+            while (query.next()) {}
+            const qint64 remaining = pragmaValue("freelist_count");
+            if (remaining < 0)
+                return false;
+            if (remaining >= freePages)
+                break;
+            freePages = remaining;
+        }
+    }
+    stats.vacuumMs = timer.restart();
+
+    if (!query.exec("ANALYZE")) {
+        qDebug() << "Error al actualizar las estadísticas:" << query.lastError().text();
+        return false;
+    }
+    if (!query.exec("PRAGMA wal_checkpoint(TRUNCATE)"))
+        qDebug() << "No se pudo truncar el WAL:" << query.lastError().text();
+    query.finish();
+    stats.analyzeMs = timer.elapsed();
+
+    stats.bytesAfter = pragmaValue("page_count") * pageSize;
+    stats.freePagesAfter = pragmaValue("freelist_count");
+    return stats.bytesAfter >= 0 && stats.freePagesAfter >= 0;
+}
+
+/// @brief Inicia una transacción explícita.
+/// @return true si la transacción se abre; false en caso de error.
+bool DatabaseManager::beginTransaction()
+{
+    if (!m_db.transaction()) {
+        qDebug() << "Error al iniciar transacción:" << m_db.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+/// @brief Confirma la transacción abierta.
+/// @return true si la transacción se confirma; false en caso de error.
+bool DatabaseManager::commitTransaction()
+{
+    if (!m_db.commit()) {
+        qDebug() << "Error al confirmar transacción:" << m_db.lastError().text();
+        return false;
+    }
+    return true;
+}
 
+/// @brief Descarta la transacción abierta.
+/// @return true si la transacción se descarta; false en caso de error.
+bool DatabaseManager::rollbackTransaction()
+{
+    if (!m_db.rollback()) {
+        qDebug() << "Error al descartar transacción:" << m_db.lastError().text();
+        return false;
+    }
+    return true;
+}
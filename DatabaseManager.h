@@ -5,10 +5,73 @@
 #define DATABASEMANAGER_H
 
 #include <QObject>
+#include <QElapsedTimer>
 #include <QSqlDatabase>
+#include <QHash>
+#include <QMap>
 #include "Component.h"
+#include <functional>
 #include <vector>
 
+class QSqlQuery;
+
+/// @struct ChangeRecord
+/// @brief Entrada del registro de cambios de la tabla de componentes.
+///
+/// El registro solo guarda la operación y el ID; el contenido es el estado actual de
+/// la fila en el momento de la lectura, por lo que aplicar los cambios es idempotente
+/// y varias entradas del mismo ID pueden reducirse a la última.
+struct ChangeRecord {
+    /// @brief Operación que originó el cambio.
+    enum Operation { Insert, Update, Delete };
+
+    qint64 sequence;      ///< Número de secuencia monótono del cambio.
+    Operation operation;  ///< Operación registrada.
+    int componentId;      ///< ID de la fila afectada.
+    QString changedAt;    ///< Instante del cambio (ISO 8601, UTC).
+    bool exists;          ///< La fila existe todavía y component contiene su estado actual.
+    Component component;  ///< Estado actual de la fila (solo si exists).
+};
+
+/// @struct MaintenanceStats
+/// @brief Resultado de una pasada de mantenimiento (compactación y estadísticas) de una base de datos.
+struct MaintenanceStats {
+    qint64 bytesBefore;     ///< Tamaño de la base de datos antes del mantenimiento (páginas × tamaño de página).
+    qint64 bytesAfter;      ///< Tamaño de la base de datos después del mantenimiento.
+    qint64 freePagesBefore; ///< Páginas libres antes del mantenimiento.
+    qint64 freePagesAfter;  ///< Páginas libres después del mantenimiento.
+    bool fullVacuum;        ///< Se ha hecho el VACUUM completo que activa el modo incremental.
+    qint64 vacuumMs;        ///< Tiempo de compactación en ms.
+    qint64 analyzeMs;       ///< Tiempo de ANALYZE y del punto de control del WAL en ms.
+};
+
+/// @struct AgingBucket
+/// @brief Componentes y unidades de una franja de antigüedad.
+struct AgingBucket {
+    qint64 components; ///< Componentes (filas) de la franja.
+    qint64 units;      ///< Suma de sus cantidades.
+};
+
+/// @struct AgingHistogram
+/// @brief Histograma de antigüedad (días desde la compra) por tipo de componente.
+///
+/// La franja i recoge los componentes con antigüedad hasta bounds[i] días (y mayor que
+/// bounds[i - 1]); la última franja, los de más de bounds.back() días.
+struct AgingHistogram {
+    AgingHistogram();
+
+    QDate today;                                    ///< Fecha de referencia de la antigüedad.
+    std::vector<int> bounds;                        ///< Límites de las franjas en días, crecientes.
+    QMap<QString, std::vector<AgingBucket>> byType; ///< Franjas por tipo (bounds.size() + 1 cada una).
+    qint64 undated;                                 ///< Componentes sin fecha de compra válida.
+
+    /// @brief Suma las franjas de otro histograma con los mismos límites.
+    void add(const AgingHistogram &other);
+
+    /// @brief Etiqueta de una franja (p. ej. "31-90" o ">365").
+    QString bucketLabel(std::size_t index) const;
+};
+
 /// @class DatabaseManager
 /// @brief Clase que administra la conexión y las operaciones CRUD sobre la base de datos de componentes.
 ///
@@ -28,20 +91,46 @@ public:
 
     /// @brief Abre una conexión a la base de datos SQLite en la ruta especificada.
     /// @param path Ruta al archivo de base de datos.
+    /// @param connectionName Nombre de la conexión Qt (una por hilo).
     /// @return true si la conexión se abre exitosamente; false en caso de error.
-    bool openDatabase(const QString &path);
+    bool openDatabase(const QString &path,
+                      const QString &connectionName = "qt_inventory_connection");
 
     /// @brief Cierra la conexión a la base de datos.
     void closeDatabase();
 
-    /// @brief Crea las tablas necesarias en la base de datos si no existen.
-    /// @return true si la creación (o existencia previa) de las tablas es exitosa; false en caso de error.
+    /// @brief Crea las tablas necesarias y aplica la parte síncrona de las migraciones pendientes.
+    /// @return true si el esquema queda utilizable; false en caso de error.
     bool initializeTables();
 
+    /// @brief Versión del esquema (PRAGMA user_version).
+    ///        Se guarda en memoria; mientras es anterior a la última, se vuelve a leer como
+    ///        mucho una vez por segundo, por si otra conexión completa las migraciones.
+    /// @return Versión del esquema almacenada en la base de datos.
+    int schemaVersion();
+
+    /// @brief Versión del esquema que espera la aplicación.
+    /// @return Versión de la última migración conocida.
+    static int latestSchemaVersion();
+
+    /// @brief Indica si quedan migraciones con trabajo en segundo plano (rellenos o índices).
+    /// @return true si hay trabajo de migración pendiente.
+    bool hasPendingMigrations() const;
+
+    /// @brief Ejecuta por lotes, desde el bucle de eventos, el trabajo pendiente de las migraciones.
+    /// @param batchSize Número de IDs procesados en cada lote de relleno.
+    void startBackgroundMigrations(int batchSize = 5000);
+
     /// @brief Inserta un nuevo componente en la tabla de componentes.
     /// @param component Objeto Component con los datos a insertar.
+    /// @param newId Si no es nullptr, recibe el ID asignado a la nueva fila.
     /// @return true si la inserción se realiza correctamente; false en caso de error.
-    bool addComponent(const Component &component);
+    bool addComponent(const Component &component, int *newId = nullptr);
+
+    /// @brief Reinserta un componente conservando su ID original (p. ej. al deshacer una eliminación).
+    /// @param component Objeto Component cuyo ID debe estar libre en la tabla.
+    /// @return true si la inserción se realiza correctamente; false en caso de error.
+    bool restoreComponent(const Component &component);
 
     /// @brief Actualiza los datos de un componente existente.
     /// @param component Objeto Component con el ID y los nuevos valores a actualizar.
@@ -52,17 +141,175 @@ public:
     /// @return true si la eliminación es exitosa; false en caso de error.
     bool removeComponent(int id);
 
-    /// @brief Recupera todos los componentes almacenados en la base de datos.
-    /// @return Vector de objetos Component con todos los registros encontrados.
-    std::vector<Component> fetchAllComponents();
+    /// @brief Suma unidades a la cantidad de un componente con un único UPDATE atómico.
+    /// @param id Identificador del componente.
+    /// @param delta Unidades a sumar (negativo para restar).
+    /// @return true si el componente existe y se actualiza; false en caso contrario.
+    bool adjustQuantity(int id, int delta);
+
+    /// @brief Recupera el resumen de todos los componentes almacenados en la base de datos.
+    /// @param limit Número máximo de filas; negativo sin límite.
+    /// @return Vector de ComponentSummary con todos los registros encontrados.
+    std::vector<ComponentSummary> fetchAllComponents(int limit = -1);
+
+    /// @brief Recorre todos los componentes fila a fila sin cargarlos todos en memoria.
+    /// @param visitor Función llamada con cada componente; si devuelve false se detiene el recorrido.
+    /// @return true si el recorrido se completa (o lo detiene el visitante); false si la consulta falla.
+    bool forEachComponent(const std::function<bool(const Component &)> &visitor);
 
     /// @brief Busca componentes cuyo nombre o tipo contenga la palabra clave proporcionada.
     /// @param keyword Cadena utilizada como filtro de búsqueda.
-    /// @return Vector de objetos Component que coinciden con la búsqueda.
-    std::vector<Component> searchComponents(const QString &keyword);
+    /// @param limit Número máximo de filas; negativo sin límite.
+    /// @return Vector de ComponentSummary que coinciden con la búsqueda.
+    std::vector<ComponentSummary> searchComponents(const QString &keyword, int limit = -1);
+
+    /// @brief Recupera un único componente por su ID, con todos sus campos de detalle.
+    /// @param id Identificador del componente.
+    /// @param component Objeto que recibe los datos leídos.
+    /// @return true si el componente existe; false si no existe o hay un error.
+    bool fetchComponent(int id, Component &component);
+
+    /// @brief Obtiene el ID del componente que tiene asignado un código de barras.
+    /// @param barcode Código de barras leído.
+    /// @param id Recibe el ID del componente.
+    /// @return true si el código está asignado; false si no existe o hay un error.
+    bool fetchComponentIdByBarcode(const QString &barcode, int &id);
+
+    /// @brief Recupera los componentes en o por debajo de su umbral de reposición efectivo.
+    /// @param defaultThreshold Umbral general para los componentes sin umbral propio ni de tipo.
+    /// @param limit Número máximo de filas; negativo sin límite.
+    /// @return Vector de ComponentSummary con bajo stock.
+    std::vector<ComponentSummary> fetchLowStockComponents(int defaultThreshold, int limit = -1);
+
+    /// @brief Recupera los componentes comprados en un intervalo de fechas, del más antiguo al más reciente.
+    /// @param from Primera fecha incluida (no válida: sin límite inferior).
+    /// @param to Última fecha incluida (no válida: sin límite superior).
+    /// @param type Si no está vacío, solo los componentes de este tipo.
+    /// @param limit Número máximo de filas; negativo sin límite.
+    /// @return Vector de ComponentSummary ordenado por fecha de compra.
+    std::vector<ComponentSummary> fetchComponentsPurchasedBetween(const QDate &from, const QDate &to,
+                                                                  const QString &type = QString(), int limit = -1);
+
+    /// @brief Suma al histograma los componentes de esta base de datos por tipo y franja de antigüedad.
+    ///        Recorre todo el índice de purchase_day: el coste crece con el número de componentes.
+    /// @param histogram Histograma con la fecha de referencia y los límites ya fijados.
+    /// @return true si la consulta se ejecuta; false en caso de error.
+    bool accumulateAgingHistogram(AgingHistogram &histogram);
+
+    /// @brief Guarda (o elimina) el umbral de reposición de un tipo de componente.
+    /// @param type Tipo de componente.
+    /// @param threshold Umbral del tipo; un valor negativo elimina el registro.
+    /// @return true si la operación se realiza correctamente; false en caso de error.
+    bool setTypeThreshold(const QString &type, int threshold);
+
+    /// @brief Recupera todos los umbrales de reposición por tipo.
+    /// @return Tabla tipo → umbral.
+    QHash<QString, int> fetchTypeThresholds();
+
+    /// @brief Recorre los cambios registrados con secuencia mayor que `since`, en orden.
+    /// @param since Última secuencia ya procesada por el destinatario (0 para todo el historial).
+    /// @param visitor Función llamada con cada cambio; si devuelve false se detiene el recorrido.
+    /// @param limit Número máximo de cambios a entregar (negativo sin límite).
+    /// @return true si la consulta se ejecuta; false en caso de error.
+    bool forEachChangeSince(qint64 since, const std::function<bool(const ChangeRecord &)> &visitor,
+                            int limit = -1);
+
+    /// @brief Secuencia del último cambio registrado.
+    /// @return Secuencia más alta (0 si no hay cambios) o -1 en caso de error.
+    qint64 latestChangeSequence();
+
+    /// @brief Elimina del registro los cambios con secuencia menor o igual a la indicada.
+    /// @param upToSequence Última secuencia a eliminar.
+    /// @return true si la operación se realiza correctamente; false en caso de error.
+    bool pruneChanges(qint64 upToSequence);
+
+    /// @brief Reserva un rango de IDs para esta base de datos (p. ej. un fragmento del inventario).
+    /// @param first Primer ID del rango; los IDs nuevos se asignan a partir de él.
+    /// @param last Último ID del rango.
+    /// @return true si las filas existentes están dentro del rango; false si no o hay un error.
+    bool reserveIdRange(qint64 first, qint64 last);
+
+    /// @brief Copia la base de datos a un archivo con una instantánea consistente.
+    /// @param path Ruta del archivo de copia; si existe se reemplaza al terminar.
+    /// @return true si la copia se completa; false en caso de error.
+    bool backupTo(const QString &path);
+
+    /// @brief Compacta el archivo, actualiza las estadísticas del planificador y trunca el WAL.
+    /// @param stats Recibe los tamaños y tiempos antes y después.
+    /// @param pagesPerStep Páginas liberadas en cada paso de la compactación incremental.
+    /// @return true si el mantenimiento se completa; false en caso de error.
+    bool runMaintenance(MaintenanceStats &stats, int pagesPerStep = 256);
+
+    /// @brief Inicia una transacción explícita en la conexión.
+    /// @return true si la transacción se inicia correctamente; false en caso de error.
+    bool beginTransaction();
+
+    /// @brief Confirma la transacción abierta.
+    /// @return true si la confirmación se realiza correctamente; false en caso de error.
+    bool commitTransaction();
+
+    /// @brief Descarta la transacción abierta.
+    /// @return true si la transacción se descarta correctamente; false en caso de error.
+    bool rollbackTransaction();
+
+signals:
+    /// @brief Informa del avance de la migración en segundo plano.
+    /// @param version Versión del esquema que se está aplicando.
+    /// @param done Trabajo completado (IDs rellenados o sentencias ejecutadas).
+    /// @param total Trabajo total de la fase en curso.
+    void migrationProgress(int version, qint64 done, qint64 total);
+
+    /// @brief Se emite al terminar (o abortar) las migraciones en segundo plano.
+    /// @param ok true si todas las migraciones se completan sin errores.
+    void migrationsFinished(bool ok);
 
 private:
     QSqlDatabase m_db;  ///< Objeto que representa la conexión a la base de datos SQLite.
+
+    std::vector<std::size_t> m_pendingMigrations; ///< Migraciones con trabajo en segundo plano pendiente.
+    int m_migrationBatchSize;   ///< IDs procesados por lote de relleno.
+    qint64 m_backfillCursor;    ///< Último ID rellenado de la migración en curso.
+    qint64 m_backfillStart;     ///< ID anterior al primero a rellenar (origen del avance).
+    qint64 m_backfillMaxId;     ///< ID máximo a rellenar (-1 si aún no se ha calculado).
+    int m_deferredIndex;        ///< Siguiente sentencia diferida de la migración en curso.
+    int m_schemaVersion;        ///< Última versión del esquema leída o guardada (-1 si no se conoce).
+    QElapsedTimer m_schemaVersionAge; ///< Tiempo desde la última lectura de user_version.
+
+    /// @brief Ejecuta un lote de relleno o una sentencia diferida y programa el siguiente paso.
+    void runMigrationStep();
+
+    /// @brief Expresión SQL del día de compra (días desde 1970-01-01).
+    /// @return La columna indexada purchase_day si su migración está completa; si no, el
+    ///         cálculo a partir de purchase_date.
+    QString purchaseDayExpression();
+
+    /// @brief Lee el valor entero de un PRAGMA sin argumentos.
+    /// @param pragma Nombre del PRAGMA (p. ej. "page_count").
+    /// @return Valor leído, o -1 en caso de error.
+    qint64 pragmaValue(const QString &pragma);
+
+    /// @brief Guarda la versión del esquema en PRAGMA user_version.
+    /// @param version Versión a guardar.
+    /// @return true si se guarda correctamente; false en caso de error.
+    bool setSchemaVersion(int version);
+
+    /// @brief Añade una columna a una tabla existente si todavía no existe.
+    /// @param table Nombre de la tabla.
+    /// @param column Nombre de la columna.
+    /// @param definition Tipo y restricciones de la columna.
+    /// @return true si la columna existe o se añade correctamente; false en caso de error.
+    bool ensureColumn(const QString &table, const QString &column, const QString &definition);
+
+    /// @brief Construye un Component a partir de la fila actual de una consulta.
+    /// @param query Consulta posicionada en una fila con las columnas estándar de componentes.
+    /// @param first Posición de la columna id dentro de la fila (por defecto 0).
+    /// @return Componente leído.
+    static Component readComponent(const QSqlQuery &query, int first = 0);
+
+    /// @brief Construye un ComponentSummary a partir de la fila actual de una consulta de listado.
+    /// @param query Consulta posicionada en una fila con las columnas de listado.
+    /// @return Resumen leído.
+    static ComponentSummary readSummary(const QSqlQuery &query);
 };
 
 #endif // DATABASEMANAGER_H
@@ -0,0 +1,221 @@
+/// @file FuzzyIndex.cpp
+/// @brief Implementación del índice de trigramas para búsqueda aproximada.
+
+#include "FuzzyIndex.h"
+#include <algorithm>
+
+namespace {
+/// Número mínimo de entradas muertas antes de considerar una compactación.
+const std::size_t kMinDeadSlotsToCompact = 1024;
+/// Coste aproximado de un nodo de std::unordered_map (enlace, hash y cubeta) sin el valor.
+const qint64 kHashNodeOverhead = 32;
+
+/// @brief Codifica tres unidades UTF-16 en un entero de 64 bits.
+quint64 encodeGram(ushort a, ushort b, ushort c)
+{
+    return (quint64(a) << 32) | (quint64(b) << 16) | quint64(c);
+}
+}
+
+/// @brief Construye un índice vacío.
+FuzzyIndex::FuzzyIndex()
+    : m_deadSlots(0)
+    , m_postingEntries(0)
+{}
+
+/// @brief Elimina todas las entradas y libera las listas invertidas.
+void FuzzyIndex::clear()
+{
+    m_slots.clear();
+    m_slotById.clear();
+    m_postings.clear();
+    m_deadSlots = 0;
+    m_postingEntries = 0;
+    std::vector<Slot>().swap(m_slots);
+    std::vector<quint16>().swap(m_counts);
+    std::vector<quint32>().swap(m_touched);
+}
+
+/// @brief Indexa nombre, tipo y ubicación de un componente.
+///        Si el componente ya estaba indexado, su entrada anterior se marca como muerta.
+/// @param component Componente a indexar.
+void FuzzyIndex::insert(const Component &component)
+{
+    remove(component.id());
+
+    const std::vector<quint64> grams =
+        trigrams(component.name() + ' ' + component.type() + ' ' + component.location());
+    const quint32 slot = quint32(m_slots.size());
+    Slot entry;
+    entry.id = component.id();
+    entry.gramCount = quint32(grams.size());
+    entry.alive = true;
+    m_slots.push_back(entry);
+    m_slotById[component.id()] = slot;
+    for (quint64 gram : grams)
+        m_postings[gram].push_back(slot);
+    m_postingEntries += grams.size();
+}
+
+/// @brief Marca como muerta la entrada de un componente y compacta si es necesario.
+/// @param id Identificador del componente.
+void FuzzyIndex::remove(int id)
+{
+    auto it = m_slotById.find(id);
+    if (it == m_slotById.end())
+        return;
+    m_slots[it->second].alive = false;
+    m_slotById.erase(it);
+    ++m_deadSlots;
+    if (m_deadSlots >= kMinDeadSlotsToCompact && m_deadSlots * 2 > m_slots.size())
+        compact();
+}
+
+/// @brief Número de componentes vivos en el índice.
+/// @return Cantidad de entradas vivas.
+int FuzzyIndex::size() const
+{
+    return int(m_slotById.size());
+}
+
+/// @brief Estima la memoria del índice a partir de sus contenedores.
+/// @return Bytes aproximados.
+qint64 FuzzyIndex::memoryUsage() const
+{
+    return qint64(m_slots.capacity() * sizeof(Slot))
+           + qint64(m_slotById.size()) * (kHashNodeOverhead + qint64(sizeof(std::pair<int, quint32>)))
+           + qint64(m_postings.size())
+                 * (kHashNodeOverhead + qint64(sizeof(std::pair<quint64, std::vector<quint32>>)))
+           + qint64(m_postingEntries * sizeof(quint32))
+           + qint64(m_counts.capacity() * sizeof(quint16) + m_touched.capacity() * sizeof(quint32));
+}
+
+/// @brief Busca los componentes con mayor similitud de trigramas con la consulta.
+/// @param query Texto buscado.
+/// @param topK Número máximo de resultados.
+/// @param minScore Similitud mínima (índice de Jaccard) para incluir un resultado.
+/// @return Resultados ordenados de mayor a menor similitud.
+std::vector<FuzzyMatch> FuzzyIndex::search(const QString &query, int topK, double minScore) const
+{
+    std::vector<FuzzyMatch> matches;
+    const std::vector<quint64> grams = trigrams(query);
+    if (grams.empty() || topK <= 0)
+        return matches;
+
+    if (m_counts.size() < m_slots.size())
+        m_counts.resize(m_slots.size(), 0);
+    m_touched.clear();
+
+    // Cuenta cuántos trigramas de la consulta comparte cada entrada
+    for (quint64 gram : grams) {
+        auto it = m_postings.find(gram);
+        if (it == m_postings.end())
+            continue;
+        for (quint32 slot : it->second) {
+            if (m_counts[slot] == 0)
+                m_touched.push_back(slot);
+            ++m_counts[slot];
+        }
+    }
+
+    const double queryCount = double(grams.size());
+    for (quint32 slot : m_touched) {
+        const Slot &entry = m_slots[slot];
+        const double shared = m_counts[slot];
+        m_counts[slot] = 0;
+        if (!entry.alive)
+            continue;
+        const double score = shared / (queryCount + entry.gramCount - shared);
+        if (score >= minScore) {
+            FuzzyMatch match;
+            match.id = entry.id;
+            match.score = score;
+            matches.push_back(match);
+        }
+    }
+
+    auto byScore = [](const FuzzyMatch &a, const FuzzyMatch &b) {
+        return a.score > b.score || (a.score == b.score && a.id < b.id);
+    };
+    if (matches.size() > std::size_t(topK)) {
+        std::partial_sort(matches.begin(), matches.begin() + topK, matches.end(), byScore);
+        matches.resize(topK);
+    } else {
+        std::sort(matches.begin(), matches.end(), byScore);
+    }
+    return matches;
+}
+
+/// @brief Normaliza el texto y calcula sus trigramas por palabra.
+///        Solo letras y dígitos forman palabras; cada palabra se rellena con dos
+///        espacios al inicio y uno al final antes de extraer los trigramas.
+/// @param text Texto de entrada.
+/// @return Trigramas codificados, ordenados y sin duplicados.
+std::vector<quint64> FuzzyIndex::trigrams(const QString &text)
+{
+    std::vector<quint64> grams;
+    const QString lower = text.toLower();
+    std::vector<ushort> word;
+    word.reserve(32);
+
+    auto flushWord = [&grams, &word]() {
+        if (word.empty())
+            return;
+        word.insert(word.begin(), 2, ushort(' '));
+        word.push_back(ushort(' '));
+        for (std::size_t i = 0; i + 2 < word.size(); ++i)
+            grams.push_back(encodeGram(word[i], word[i + 1], word[i + 2]));
+        word.clear();
+    };
+
+    for (const QChar ch : lower) {
+        if (ch.isLetterOrNumber())
+            word.push_back(ch.unicode());
+        else
+            flushWord();
+    }
+    flushWord();
+
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+    return grams;
+}
+
+/// @brief Reasigna las entradas vivas a posiciones contiguas y filtra las listas invertidas.
+void FuzzyIndex::compact()
+{
+    const quint32 dead = quint32(-1);
+    std::vector<quint32> remap(m_slots.size(), dead);
+    std::vector<Slot> slots;
+    slots.reserve(m_slotById.size());
+    m_postingEntries = 0;
+    for (std::size_t i = 0; i < m_slots.size(); ++i) {
+        if (!m_slots[i].alive)
+            continue;
+        remap[i] = quint32(slots.size());
+        slots.push_back(m_slots[i]);
+    }
+
+    for (auto it = m_postings.begin(); it != m_postings.end();) {
+        std::vector<quint32> &list = it->second;
+        std::size_t out = 0;
+        for (quint32 slot : list) {
+            if (remap[slot] != dead)
+                list[out++] = remap[slot];
+        }
+        list.resize(out);
+        m_postingEntries += out;
+        if (list.empty()) {
+            it = m_postings.erase(it);
+        } else {
+            list.shrink_to_fit();
+            ++it;
+        }
+    }
+
+    for (auto &entry : m_slotById)
+        entry.second = remap[entry.second];
+    m_slots.swap(slots);
+    m_deadSlots = 0;
+    m_counts.clear();
+}
@@ -0,0 +1,89 @@
+/// @file FuzzyIndex.h
+/// @brief Declaración de la clase FuzzyIndex, índice de trigramas para búsqueda aproximada de componentes.
+
+#ifndef FUZZYINDEX_H
+#define FUZZYINDEX_H
+
+#include <QString>
+#include <QtGlobal>
+#include <unordered_map>
+#include <vector>
+#include "Component.h"
+
+/// @struct FuzzyMatch
+/// @brief Resultado de una búsqueda aproximada: ID del componente y su puntuación de similitud.
+struct FuzzyMatch {
+    int id;        ///< Identificador del componente.
+    double score;  ///< Similitud de Jaccard entre trigramas (0 a 1).
+};
+
+/// @class FuzzyIndex
+/// @brief Índice invertido en memoria de trigramas sobre nombre, tipo y ubicación.
+///
+/// Cada palabra del texto se normaliza a minúsculas y se descompone en trigramas con
+/// relleno inicial ("  r", " re", "res", ...), de modo que errores tipográficos o
+/// variaciones de escritura comparten la mayoría de trigramas con el texto original.
+/// La similitud de un candidato es el índice de Jaccard entre sus trigramas y los de la
+/// consulta. El índice se actualiza de forma incremental: las eliminaciones marcan la
+/// entrada como muerta y las listas se compactan cuando las entradas muertas predominan.
+///
+/// search() reutiliza búferes internos, por lo que el índice no debe consultarse desde
+/// varios hilos a la vez.
+class FuzzyIndex {
+public:
+    /// @brief Construye un índice vacío.
+    FuzzyIndex();
+
+    /// @brief Elimina todas las entradas del índice.
+    void clear();
+
+    /// @brief Indexa un componente (o reemplaza su entrada si ya existía).
+    /// @param component Componente a indexar.
+    void insert(const Component &component);
+
+    /// @brief Elimina un componente del índice.
+    /// @param id Identificador del componente.
+    void remove(int id);
+
+    /// @brief Número de componentes indexados.
+    /// @return Cantidad de entradas vivas.
+    int size() const;
+
+    /// @brief Estimación de la memoria ocupada por el índice.
+    /// @return Bytes aproximados de entradas, listas invertidas y búferes de búsqueda.
+    qint64 memoryUsage() const;
+
+    /// @brief Busca los componentes más parecidos a la consulta.
+    /// @param query Texto buscado.
+    /// @param topK Número máximo de resultados.
+    /// @param minScore Similitud mínima para incluir un resultado.
+    /// @return Resultados ordenados por similitud descendente.
+    std::vector<FuzzyMatch> search(const QString &query, int topK, double minScore = 0.2) const;
+
+private:
+    /// @brief Entrada del índice asociada a un componente.
+    struct Slot {
+        int id;             ///< Identificador del componente.
+        quint32 gramCount;  ///< Número de trigramas distintos del componente.
+        bool alive;         ///< false si el componente se ha eliminado o reindexado.
+    };
+
+    /// @brief Calcula los trigramas distintos de un texto normalizado.
+    /// @param text Texto de entrada.
+    /// @return Trigramas codificados, ordenados y sin repetir.
+    static std::vector<quint64> trigrams(const QString &text);
+
+    /// @brief Reconstruye las listas invertidas descartando las entradas muertas.
+    void compact();
+
+    std::vector<Slot> m_slots;                                   ///< Entradas indexadas.
+    std::unordered_map<int, quint32> m_slotById;                 ///< ID de componente → entrada viva.
+    std::unordered_map<quint64, std::vector<quint32>> m_postings; ///< Trigrama → entradas que lo contienen.
+    std::size_t m_deadSlots;                                     ///< Entradas muertas pendientes de compactar.
+    std::size_t m_postingEntries;                                ///< Suma de las longitudes de las listas invertidas.
+
+    mutable std::vector<quint16> m_counts;   ///< Búfer de coincidencias por entrada durante search().
+    mutable std::vector<quint32> m_touched;  ///< Entradas con coincidencias en la consulta actual.
+};
+
+#endif // FUZZYINDEX_H
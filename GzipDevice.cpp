@@ -0,0 +1,211 @@
+/// @file GzipDevice.cpp
+/// @brief Implementación del dispositivo de compresión gzip en flujo con hilo compresor.
+
+#include "GzipDevice.h"
+#include <QDebug>
+#include <zlib.h>
+
+namespace {
+/// Tamaño de los bloques que se entregan al compresor.
+const int kChunkSize = 256 * 1024;
+/// Bloques que pueden esperar en la cola antes de frenar al escritor.
+const std::size_t kMaxQueuedChunks = 4;
+/// Bits de ventana de deflate; sumar 16 produce cabecera y cola gzip en lugar de zlib.
+const int kGzipWindowBits = 15 + 16;
+/// Memoria de deflate con ventana de 15 bits y memLevel 8 (según la documentación de zlib).
+const qint64 kDeflateStateBytes = (qint64(1) << 17) + (qint64(1) << 18);
+}
+
+/// @brief Constructor de GzipDevice.
+/// @param sink Dispositivo de destino abierto para escritura.
+/// @param level Nivel de compresión (-1 a 9).
+/// @param parent Objeto padre en la jerarquía de Qt.
+GzipDevice::GzipDevice(QIODevice *sink, int level, QObject *parent)
+    : QIODevice(parent)
+    , m_sink(sink)
+    , m_level(qBound(-1, level, 9))
+    , m_stream(nullptr)
+    , m_finishing(false)
+    , m_failed(false)
+    , m_account("Compresión gzip", MemoryBudget::Buffer)
+{}
+
+/// @brief Destructor de GzipDevice. Cierra el flujo si sigue abierto.
+GzipDevice::~GzipDevice()
+{
+    if (isOpen())
+        close();
+}
+
+/// @brief Inicializa zlib en modo gzip y arranca el hilo compresor.
+/// @param mode Modo de apertura; solo se admite escritura.
+/// @return true si el dispositivo queda abierto.
+bool GzipDevice::open(OpenMode mode)
+{
+    if (isOpen() || (mode & ReadOnly) || !(mode & WriteOnly) || !m_sink || !m_sink->isWritable())
+        return false;
+
+    m_stream = new z_stream;
+    m_stream->zalloc = Z_NULL;
+    m_stream->zfree = Z_NULL;
+    m_stream->opaque = Z_NULL;
+    if (deflateInit2(m_stream, m_level, Z_DEFLATED, kGzipWindowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        qDebug() << "Error al inicializar zlib:" << (m_stream->msg ? m_stream->msg : "");
+        delete m_stream;
+        m_stream = nullptr;
+        return false;
+    }
+
+    m_buffer.clear();
+    m_buffer.reserve(kChunkSize);
+    m_queue.clear();
+    m_finishing = false;
+    m_failed = false;
+    // Bloque en curso, cola llena y búfer de salida del compresor
+    m_account.setUsage(qint64(kMaxQueuedChunks + 2) * kChunkSize + kDeflateStateBytes);
+    m_thread = std::thread(&GzipDevice::compressLoop, this);
+    return QIODevice::open(mode | Unbuffered);
+}
+
+/// @brief Entrega el último bloque, espera a que el compresor termine y libera zlib.
+void GzipDevice::close()
+{
+    if (!isOpen())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_buffer.isEmpty()) {
+            m_queue.push_back(m_buffer);
+            m_buffer.clear();
+        }
+        m_finishing = true;
+    }
+    m_cond.notify_all();
+    m_thread.join();
+
+    deflateEnd(m_stream);
+    delete m_stream;
+    m_stream = nullptr;
+    m_account.setUsage(0);
+    QIODevice::close();
+}
+
+/// @brief El dispositivo es secuencial.
+bool GzipDevice::isSequential() const
+{
+    return true;
+}
+
+/// @brief Indica si ha fallado la compresión o la escritura en el destino.
+bool GzipDevice::hasError() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_failed;
+}
+
+/// @brief Indica si la ruta termina en .gz (sin distinguir mayúsculas).
+/// @param filePath Ruta del archivo.
+bool GzipDevice::isGzipPath(const QString &filePath)
+{
+    return filePath.endsWith(".gz", Qt::CaseInsensitive);
+}
+
+/// @brief No se admite lectura.
+qint64 GzipDevice::readData(char *, qint64)
+{
+    return -1;
+}
+
+/// @brief Acumula los datos en el bloque en curso y lo entrega al compresor cuando se llena.
+/// @param data Datos a escribir.
+/// @param maxSize Número de bytes.
+/// @return Bytes aceptados, o -1 si el compresor ha fallado.
+qint64 GzipDevice::writeData(const char *data, qint64 maxSize)
+{
+    qint64 written = 0;
+    while (written < maxSize) {
+        const int room = kChunkSize - m_buffer.size();
+        const int take = int(qMin<qint64>(room, maxSize - written));
+        m_buffer.append(data + written, take);
+        written += take;
+        if (m_buffer.size() >= kChunkSize && !submit(m_buffer))
+            return -1;
+    }
+    return written;
+}
+
+/// @brief Encola el bloque (dejándolo vacío) cuando haya hueco en la cola.
+/// @param chunk Bloque a entregar.
+/// @return false si el compresor ha fallado.
+bool GzipDevice::submit(QByteArray &chunk)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cond.wait(lock, [this] { return m_failed || m_queue.size() < kMaxQueuedChunks; });
+    if (m_failed)
+        return false;
+    m_queue.push_back(chunk);
+    lock.unlock();
+    m_cond.notify_all();
+
+    chunk = QByteArray();
+    chunk.reserve(kChunkSize);
+    return true;
+}
+
+/// @brief Bucle del hilo compresor.
+void GzipDevice::compressLoop()
+{
+    QByteArray out(kChunkSize, Qt::Uninitialized);
+    for (;;) {
+        QByteArray chunk;
+        bool finish = false;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cond.wait(lock, [this] { return !m_queue.empty() || m_finishing; });
+            if (!m_queue.empty()) {
+                chunk = m_queue.front();
+                m_queue.pop_front();
+            }
+            finish = m_finishing && m_queue.empty();
+        }
+        m_cond.notify_all();
+
+        if (!deflateChunk(chunk, finish, out)) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_failed = true;
+            m_queue.clear();
+            m_cond.notify_all();
+            return;
+        }
+        if (finish)
+            return;
+    }
+}
+
+/// @brief Comprime un bloque con deflate y escribe en el destino toda la salida producida.
+/// @param chunk Datos de entrada (puede estar vacío al cerrar).
+/// @param finish true para escribir el final del flujo gzip.
+/// @param out Búfer de salida reutilizable.
+/// @return true si todo es correcto.
+bool GzipDevice::deflateChunk(const QByteArray &chunk, bool finish, QByteArray &out)
+{
+    m_stream->next_in = reinterpret_cast<Bytef *>(const_cast<char *>(chunk.constData()));
+    m_stream->avail_in = uInt(chunk.size());
+    int result = Z_OK;
+    do {
+        m_stream->next_out = reinterpret_cast<Bytef *>(out.data());
+        m_stream->avail_out = uInt(out.size());
+        result = deflate(m_stream, finish ? Z_FINISH : Z_NO_FLUSH);
+        if (result == Z_STREAM_ERROR) {
+            qDebug() << "Error al comprimir:" << (m_stream->msg ? m_stream->msg : "");
+            return false;
+        }
+        const qint64 produced = out.size() - qint64(m_stream->avail_out);
+        if (produced > 0 && m_sink->write(out.constData(), produced) != produced) {
+            qDebug() << "Error al escribir el flujo comprimido:" << m_sink->errorString();
+            return false;
+        }
+    } while (m_stream->avail_out == 0);
+    return !finish || result == Z_STREAM_END;
+}
@@ -0,0 +1,90 @@
+/// @file GzipDevice.h
+/// @brief Declaración de la clase GzipDevice, que comprime en gzip lo que se escribe en ella.
+
+#ifndef GZIPDEVICE_H
+#define GZIPDEVICE_H
+
+#include <QByteArray>
+#include <QIODevice>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include "MemoryBudget.h"
+
+struct z_stream_s;
+
+/// @class GzipDevice
+/// @brief Dispositivo de solo escritura que comprime los datos en formato gzip sobre otro dispositivo.
+///
+/// Los datos escritos se agrupan en bloques que se entregan a un hilo compresor propio,
+/// de modo que el formateo de filas y la compresión avanzan en paralelo. La cola entre
+/// ambos está acotada: si el compresor se queda atrás, la escritura espera.
+/// El dispositivo de destino solo se usa desde el hilo compresor mientras este está
+/// abierto; no debe tocarse hasta llamar a close().
+class GzipDevice : public QIODevice {
+    Q_OBJECT
+
+public:
+    /// @brief Constructor de GzipDevice.
+    /// @param sink Dispositivo de destino, ya abierto para escritura; no se toma su propiedad.
+    /// @param level Nivel de compresión de 0 (sin compresión) a 9 (máxima); -1 usa el de zlib (6).
+    /// @param parent Objeto padre en la jerarquía de Qt (por defecto nullptr).
+    explicit GzipDevice(QIODevice *sink, int level = -1, QObject *parent = nullptr);
+
+    /// @brief Destructor de GzipDevice. Cierra el flujo si sigue abierto.
+    ~GzipDevice();
+
+    /// @brief Abre el dispositivo (solo admite WriteOnly) y arranca el hilo compresor.
+    /// @param mode Modo de apertura.
+    /// @return true si zlib se inicializa correctamente.
+    bool open(OpenMode mode) override;
+
+    /// @brief Comprime los datos pendientes, escribe el final del flujo gzip y detiene el hilo.
+    void close() override;
+
+    /// @brief El dispositivo es secuencial (no admite posicionamiento).
+    bool isSequential() const override;
+
+    /// @brief Indica si ha fallado la compresión o la escritura en el destino.
+    bool hasError() const;
+
+    /// @brief Indica si una ruta corresponde a un archivo gzip por su extensión (.gz).
+    static bool isGzipPath(const QString &filePath);
+
+protected:
+    /// @brief No se admite lectura.
+    qint64 readData(char *data, qint64 maxSize) override;
+
+    /// @brief Acumula los datos y entrega al compresor cada bloque completo.
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private:
+    /// @brief Encola un bloque para el compresor, esperando si la cola está llena.
+    /// @return false si el compresor ha fallado.
+    bool submit(QByteArray &chunk);
+
+    /// @brief Bucle del hilo compresor: desencola bloques, los comprime y escribe el resultado.
+    void compressLoop();
+
+    /// @brief Comprime un bloque y escribe la salida en el destino.
+    /// @param chunk Datos de entrada.
+    /// @param finish true para cerrar el flujo gzip tras este bloque.
+    /// @param out Búfer de salida reutilizable.
+    /// @return true si la compresión y la escritura son correctas.
+    bool deflateChunk(const QByteArray &chunk, bool finish, QByteArray &out);
+
+    QIODevice *m_sink;              ///< Dispositivo de destino.
+    int m_level;                    ///< Nivel de compresión.
+    z_stream_s *m_stream;           ///< Estado de zlib (lo usa solo el hilo compresor).
+    QByteArray m_buffer;            ///< Bloque en curso, aún no entregado al compresor.
+    std::thread m_thread;           ///< Hilo compresor.
+    mutable std::mutex m_mutex;     ///< Protege la cola y los indicadores siguientes.
+    std::condition_variable m_cond; ///< Avisa de bloques nuevos, de hueco en la cola y del final.
+    std::deque<QByteArray> m_queue; ///< Bloques pendientes de comprimir.
+    bool m_finishing;               ///< No llegarán más bloques.
+    bool m_failed;                  ///< La compresión o la escritura ha fallado.
+    MemoryAccount m_account;        ///< Memoria de los bloques y de zlib mientras está abierto.
+};
+
+#endif // GZIPDEVICE_H
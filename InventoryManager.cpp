@@ -2,69 +2,1017 @@
 /// @brief Implementación de los métodos de la clase InventoryManager para la gestión de inventario.
 
 #include "InventoryManager.h"
+#include "ShardReader.h"
+#include <QSqlDatabase>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
 #include <algorithm>
+#include <future>
+
+namespace {
+/// Número máximo de operaciones conservadas en el diario de deshacer.
+const std::size_t kMaxJournalEntries = 500;
+/// IDs reservados para cada fragmento: el fragmento k usa [k * kShardIdSpan, (k + 1) * kShardIdSpan).
+const qint64 kShardIdSpan = qint64(1) << 24;
+/// Número de fragmento más alto que cabe en un ID de 31 bits.
+const int kMaxShardId = 127;
+}
 
 /// @brief Constructor de InventoryManager.
 /// @param parent Objeto padre en la jerarquía de Qt (por defecto nullptr).
 InventoryManager::InventoryManager(QObject *parent)
     : QObject(parent)
-{}
+    , m_fuzzyIndexBuilt(false)
+    , m_evictFuzzyIndex(false)
+    , m_trimJournal(false)
+    , m_fuzzyIndexAccount("Índice aproximado", MemoryBudget::Cache, [this] { m_evictFuzzyIndex = true; })
+    , m_journalAccount("Diario de deshacer", MemoryBudget::Cache, [this] { m_trimJournal = true; })
+    , m_coalesceIntervalMs(0)
+    , m_maxPendingWrites(1)
+    , m_pendingWrites(0)
+{
+    // El fragmento 0 es la base de datos de initialize() y existe siempre
+    Shard primary;
+    primary.id = 0;
+    primary.db = &m_dbManager;
+    primary.transactionOpen = false;
+    primary.indexedSequence = 0;
+    m_shards.push_back(std::move(primary));
+
+    m_journalClock.start();
+    m_flushTimer.setSingleShot(true);
+    connect(&m_flushTimer, &QTimer::timeout,
+            this, &InventoryManager::flushPendingWrites);
+    connect(&m_maintenanceTimer, &QTimer::timeout, this, [this] { maintain(); });
+    connect(&m_monitor, &LowStockMonitor::thresholdCrossed,
+            this, &InventoryManager::lowStockAlert);
+    connect(&m_monitor, &LowStockMonitor::stockRecovered,
+            this, &InventoryManager::stockReplenished);
+    connect(&m_dbManager, &DatabaseManager::migrationProgress,
+            this, &InventoryManager::migrationProgress);
+    connect(&m_dbManager, &DatabaseManager::migrationsFinished,
+            this, &InventoryManager::migrationsFinished);
+}
 /// @brief Destructor de InventoryManager.
-/// Libera recursos si es necesario.
+/// Confirma las escrituras agrupadas pendientes antes de liberar la conexión.
 InventoryManager::~InventoryManager()
-{}
+{
+    flushPendingWrites();
+    // Las conexiones de los fragmentos añadidos son propias de este gestor
+    for (Shard &shard : m_shards) {
+        shard.reader.reset();
+        if (shard.owned) {
+            shard.owned.reset();
+            QSqlDatabase::removeDatabase(shard.connectionName);
+        }
+    }
+}
 
 /// @brief Inicializa el gestor de inventario abriendo la base de datos y creando las tablas.
 /// @param dbPath Ruta al archivo de la base de datos SQLite.
+/// @param connectionName Nombre de la conexión Qt usada por este gestor.
 /// @return true si la base de datos se abre y las tablas se inicializan correctamente; false en caso de error.
-bool InventoryManager::initialize(const QString &dbPath) {
-    if (!m_dbManager.openDatabase(dbPath))
+bool InventoryManager::initialize(const QString &dbPath, const QString &connectionName) {
+    if (!m_dbManager.openDatabase(dbPath, connectionName))
+        return false;
+    if (!m_dbManager.initializeTables())
+        return false;
+    m_monitor.setTypeThresholds(m_dbManager.fetchTypeThresholds());
+
+    m_connectionName = connectionName;
+    m_shards.front().dbPath = dbPath;
+    m_shards.front().connectionName = connectionName;
+    return true;
+}
+
+/// @brief Abre, migra y registra el fragmento de un almacén.
+///        Al añadir el primer fragmento se comprueba también el rango del fragmento 0 y se
+///        arrancan los hilos lectores que permiten repartir las lecturas en paralelo.
+/// @param spec Configuración del fragmento.
+/// @return true si el fragmento queda disponible; false en caso de error.
+bool InventoryManager::addShard(const ShardSpec &spec) {
+    if (m_connectionName.isEmpty() || spec.id < 1 || spec.id > kMaxShardId || spec.warehouse.isEmpty()) {
+        qDebug() << "Error: fragmento no válido" << spec.id << spec.warehouse;
+        return false;
+    }
+    for (const Shard &shard : m_shards) {
+        if (shard.id == spec.id || shard.warehouse == spec.warehouse) {
+            qDebug() << "Error: fragmento duplicado" << spec.id << spec.warehouse;
+            return false;
+        }
+    }
+    if (m_shards.size() == 1 && !m_dbManager.reserveIdRange(1, kShardIdSpan - 1))
+        return false;
+
+    Shard shard;
+    shard.id = spec.id;
+    shard.warehouse = spec.warehouse;
+    shard.dbPath = spec.dbPath;
+    shard.connectionName = QString("%1_shard%2").arg(m_connectionName).arg(spec.id);
+    shard.owned.reset(new DatabaseManager);
+    shard.db = shard.owned.get();
+    shard.transactionOpen = false;
+    shard.indexedSequence = 0;
+    const qint64 base = spec.id * kShardIdSpan;
+    if (!shard.db->openDatabase(spec.dbPath, shard.connectionName)
+        || !shard.db->initializeTables()
+        || !shard.db->reserveIdRange(base, base + kShardIdSpan - 1)) {
+        shard.owned.reset();
+        QSqlDatabase::removeDatabase(shard.connectionName);
+        return false;
+    }
+    // Los umbrales por tipo se replican para que cada fragmento evalúe el bajo stock por sí solo
+    const QHash<QString, int> thresholds = m_dbManager.fetchTypeThresholds();
+    for (auto it = thresholds.constBegin(); it != thresholds.constEnd(); ++it)
+        shard.db->setTypeThreshold(it.key(), it.value());
+    connect(shard.db, &DatabaseManager::migrationProgress,
+            this, &InventoryManager::migrationProgress);
+    connect(shard.db, &DatabaseManager::migrationsFinished,
+            this, &InventoryManager::migrationsFinished);
+    m_shards.push_back(std::move(shard));
+
+    for (Shard &s : m_shards) {
+        if (!s.reader)
+            s.reader.reset(new ShardReader(s.dbPath, s.connectionName + "_reader"));
+    }
+    return true;
+}
+
+/// @brief Interpreta "id:ALMACEN=ruta".
+/// @param text Especificación del fragmento.
+/// @param spec Recibe la configuración.
+/// @return true si el texto es válido.
+bool InventoryManager::parseShardSpec(const QString &text, ShardSpec &spec) {
+    const int colon = text.indexOf(':');
+    const int equals = text.indexOf('=', colon + 1);
+    if (colon <= 0 || equals <= colon + 1 || equals == text.size() - 1)
         return false;
-    return m_dbManager.initializeTables();
+    bool ok = false;
+    spec.id = text.left(colon).toInt(&ok);
+    spec.warehouse = text.mid(colon + 1, equals - colon - 1).trimmed();
+    spec.dbPath = text.mid(equals + 1);
+    return ok && spec.id >= 1 && spec.id <= kMaxShardId && !spec.warehouse.isEmpty();
+}
+
+/// @brief Almacén de una ubicación con el formato "ALMACEN/posición".
+/// @param location Ubicación del componente.
+/// @return Prefijo anterior a la primera '/', o cadena vacía si no hay '/'.
+QString InventoryManager::warehouseOf(const QString &location) {
+    const int slash = location.indexOf('/');
+    return slash > 0 ? location.left(slash).trimmed() : QString();
+}
+
+/// @brief Rutas de las bases de datos de los fragmentos.
+/// @return Tabla número de fragmento → ruta.
+QMap<int, QString> InventoryManager::shardDatabasePaths() const {
+    QMap<int, QString> paths;
+    for (const Shard &shard : m_shards)
+        paths.insert(shard.id, shard.dbPath);
+    return paths;
+}
+
+/// @brief Lanza el trabajo en segundo plano de las migraciones pendientes de cada fragmento.
+void InventoryManager::startBackgroundMigrations() {
+    for (Shard &shard : m_shards) {
+        if (shard.db->hasPendingMigrations())
+            shard.db->startBackgroundMigrations();
+    }
 }
 
 /// @brief Obtiene todos los componentes del inventario.
+/// @param limit Número máximo de componentes (negativo sin límite).
+/// @param truncated Recibe si se ha alcanzado el límite.
 /// @return Vector con todos los objetos Component almacenados en la base de datos.
-std::vector<Component> InventoryManager::getAllComponents() {
-    return m_dbManager.fetchAllComponents();
+std::vector<ComponentSummary> InventoryManager::getAllComponents(int limit, bool *truncated) {
+    return gather([](DatabaseManager &db, int rows) { return db.fetchAllComponents(rows); },
+                  limit, truncated);
+}
+
+/// @brief Recorre todos los componentes con un cursor de la base de datos, fragmento a fragmento.
+/// @param visitor Función llamada con cada componente; devolver false detiene el recorrido.
+/// @return true si el recorrido se ejecuta correctamente; false en caso de error.
+bool InventoryManager::forEachComponent(const std::function<bool(const Component &)> &visitor) {
+    bool stopped = false;
+    for (Shard &shard : m_shards) {
+        const bool ok = shard.db->forEachComponent([&visitor, &stopped](const Component &c) -> bool {
+            stopped = !visitor(c);
+            return !stopped;
+        });
+        if (!ok)
+            return false;
+        if (stopped)
+            break;
+    }
+    return true;
 }
 
 /// @brief Busca componentes cuyo nombre, tipo o ubicación contenga la palabra clave.
 /// @param keyword Cadena utilizada como filtro de búsqueda.
+/// @param limit Número máximo de componentes (negativo sin límite).
+/// @param truncated Recibe si se ha alcanzado el límite.
 /// @return Vector con los componentes que coinciden con el criterio proporcionado.
-std::vector<Component> InventoryManager::searchComponents(const QString &keyword) {
-    return m_dbManager.searchComponents(keyword);
+std::vector<ComponentSummary> InventoryManager::searchComponents(const QString &keyword, int limit, bool *truncated) {
+    return gather([keyword](DatabaseManager &db, int rows) { return db.searchComponents(keyword, rows); },
+                  limit, truncated);
+}
+
+/// @brief Busca componentes por similitud de trigramas.
+///        Construye el índice en la primera llamada a partir de toda la tabla.
+/// @param query Texto buscado.
+/// @param topK Número máximo de resultados.
+/// @return Componentes ordenados por relevancia descendente.
+std::vector<ComponentSummary> InventoryManager::fuzzySearch(const QString &query, int topK) {
+    applyMemoryRequests();
+    syncFuzzyIndex();
+
+    std::vector<ComponentSummary> results;
+    for (const FuzzyMatch &match : m_fuzzyIndex.search(query, topK)) {
+        Component c;
+        if (shardForId(match.id).db->fetchComponent(match.id, c))
+            results.push_back(ComponentSummary(c));
+    }
+    return results;
+}
+
+/// @brief Construye el índice de trigramas o le aplica los cambios registrados desde la
+///        última sincronización. El registro de cambios incluye las escrituras de otras
+///        conexiones (p. ej. otros trabajadores del servidor), que no pasan por este gestor.
+void InventoryManager::syncFuzzyIndex() {
+    if (!m_fuzzyIndexBuilt) {
+        // La secuencia se toma antes de recorrer la tabla: los cambios que se cuelen durante
+        // el recorrido se vuelven a aplicar en la siguiente sincronización, sin efecto
+        for (Shard &shard : m_shards)
+            shard.indexedSequence = qMax<qint64>(0, shard.db->latestChangeSequence());
+        forEachComponent([this](const Component &c) -> bool {
+            m_fuzzyIndex.insert(c);
+            return true;
+        });
+        m_fuzzyIndexBuilt = true;
+        m_fuzzyIndexAccount.setUsage(m_fuzzyIndex.memoryUsage());
+        return;
+    }
+
+    bool pruned = false;
+    for (Shard &shard : m_shards) {
+        shard.db->forEachChangeSince(shard.indexedSequence, [this, &shard, &pruned](const ChangeRecord &change) -> bool {
+            // Si se han podado cambios aún no aplicados, el índice ya no puede ponerse al día
+            if (change.sequence > shard.indexedSequence + 1 && shard.indexedSequence > 0) {
+                pruned = true;
+                return false;
+            }
+            if (change.exists)
+                m_fuzzyIndex.insert(change.component);
+            else
+                m_fuzzyIndex.remove(change.componentId);
+            shard.indexedSequence = change.sequence;
+            return true;
+        });
+        if (pruned)
+            break;
+    }
+    if (pruned) {
+        m_fuzzyIndex.clear();
+        m_fuzzyIndexBuilt = false;
+        syncFuzzyIndex();
+        return;
+    }
+    m_fuzzyIndexAccount.setUsage(m_fuzzyIndex.memoryUsage());
 }
 
 /// @brief Agrega un nuevo componente al inventario.
 /// @param component Objeto Component con los datos del nuevo componente.
+/// @param newId Si no es nullptr, recibe el ID asignado.
 /// @return true si la inserción se realiza correctamente; false en caso de error.
-bool InventoryManager::addComponent(const Component &component) {
-    return m_dbManager.addComponent(component);
+bool InventoryManager::addComponent(const Component &component, int *newId) {
+    Component added = component;
+    if (!applyAdd(added))
+        return false;
+    if (newId)
+        *newId = added.id();
+    JournalEntry entry;
+    entry.operation = JournalEntry::Add;
+    entry.after = added;
+    record(entry);
+    return true;
 }
 
 /// @brief Actualiza un componente existente en el inventario.
 /// @param component Objeto Component con el ID y los nuevos datos a actualizar.
-/// @return true si la actualización se efectúa correctamente; false en caso de error.
+/// @return true si la actualización se efectúa correctamente; false si el componente no existe o en caso de error.
 bool InventoryManager::updateComponent(const Component &component) {
-    return m_dbManager.updateComponent(component);
+    // Sin la fila no hay nada que actualizar: no debe evaluarse ni indexarse una fila inexistente
+    Component before;
+    if (!shardForId(component.id()).db->fetchComponent(component.id(), before))
+        return false;
+    if (!applyUpdate(&before, component))
+        return false;
+    JournalEntry entry;
+    entry.operation = JournalEntry::Update;
+    entry.before = before;
+    entry.after = component;
+    record(entry);
+    return true;
+}
+
+/// @brief Ajusta el stock de un componente con un UPDATE atómico y lo registra en el diario.
+/// @param id Identificador del componente.
+/// @param delta Unidades a sumar (negativo para restar).
+/// @return true si el ajuste se realiza correctamente; false en caso de error.
+bool InventoryManager::adjustQuantity(int id, int delta) {
+    Shard &shard = shardForId(id);
+    Component before;
+    if (!shard.db->fetchComponent(id, before))
+        return false;
+    beginWrite(shard);
+    const bool ok = shard.db->adjustQuantity(id, delta);
+    if (!endWrite() || !ok)
+        return false;
+
+    // Se relee la fila: otra conexión puede haber ajustado la cantidad entre medias
+    Component after;
+    if (!shard.db->fetchComponent(id, after))
+        return true;
+    m_monitor.evaluate(&before, &after);
+    JournalEntry entry;
+    entry.operation = JournalEntry::Update;
+    entry.before = before;
+    entry.after = after;
+    record(entry);
+    return true;
+}
+
+/// @brief Aplica un lote de ajustes de stock, agrupados en una transacción por fragmento.
+///        Primero se confirman las escrituras agrupadas pendientes, de modo que el lote
+///        es una transacción propia.
+/// @param deltas Unidades a sumar por ID.
+/// @param failed Recibe los ajustes no aplicados: los del lote de cada fragmento cuya transacción
+///        se descarta por fallar un ajuste (p. ej. un ID inexistente) o la confirmación.
+/// @return true si las transacciones se confirman correctamente; false en caso de error.
+bool InventoryManager::adjustQuantities(const QHash<int, int> &deltas, QHash<int, int> *failed) {
+    if (failed)
+        failed->clear();
+    if (deltas.isEmpty())
+        return true;
+    if (!flushPendingWrites()) {
+        if (failed)
+            *failed = deltas;
+        return false;
+    }
+
+    bool ok = true;
+    std::vector<JournalEntry> entries;
+    for (Shard &shard : m_shards) {
+        std::vector<std::pair<int, int>> batch;
+        for (auto it = deltas.constBegin(); it != deltas.constEnd(); ++it) {
+            if (it.value() != 0 && shardForId(it.key()).id == shard.id)
+                batch.push_back(std::make_pair(it.key(), it.value()));
+        }
+        if (batch.empty())
+            continue;
+        const auto fail = [&]() {
+            ok = false;
+            for (const auto &item : batch) {
+                if (failed)
+                    failed->insert(item.first, item.second);
+            }
+        };
+        if (!shard.db->beginTransaction()) {
+            fail();
+            continue;
+        }
+        // Si falla un ajuste o la confirmación, se descarta el lote entero del fragmento:
+        // así ningún ajuste devuelto en failed queda aplicado
+        std::vector<JournalEntry> shardEntries;
+        bool applied = true;
+        for (const auto &item : batch) {
+            JournalEntry entry;
+            entry.operation = JournalEntry::Update;
+            applied = shard.db->fetchComponent(item.first, entry.before)
+                      && shard.db->adjustQuantity(item.first, item.second)
+                      && shard.db->fetchComponent(item.first, entry.after);
+            if (!applied)
+                break;
+            shardEntries.push_back(entry);
+        }
+        if (!applied || !shard.db->commitTransaction()) {
+            shard.db->rollbackTransaction();
+            fail();
+            continue;
+        }
+        entries.insert(entries.end(), shardEntries.begin(), shardEntries.end());
+    }
+
+    for (const JournalEntry &entry : entries) {
+        m_monitor.evaluate(&entry.before, &entry.after);
+        record(entry);
+    }
+    return ok;
+}
+
+/// @brief Busca el código de barras en cada fragmento con su índice único.
+/// @param barcode Código leído.
+/// @param id Recibe el ID del componente.
+/// @return true si el código existe.
+bool InventoryManager::componentIdForBarcode(const QString &barcode, int &id) {
+    if (barcode.isEmpty())
+        return false;
+    for (Shard &shard : m_shards) {
+        if (shard.db->fetchComponentIdByBarcode(barcode, id))
+            return true;
+    }
+    return false;
 }
 
 /// @brief Elimina un componente del inventario según su ID.
 /// @param id Identificador del componente a eliminar.
 /// @return true si la eliminación se realiza correctamente; false en caso de error.
 bool InventoryManager::removeComponent(int id) {
-    return m_dbManager.removeComponent(id);
+    Component before;
+    const bool existed = shardForId(id).db->fetchComponent(id, before);
+    if (!applyRemove(id))
+        return false;
+    if (existed) {
+        JournalEntry entry;
+        entry.operation = JournalEntry::Remove;
+        entry.before = before;
+        record(entry);
+    }
+    return true;
+}
+
+/// @brief Obtiene un componente por su ID.
+/// @param id Identificador del componente.
+/// @param component Objeto que recibe los datos leídos.
+/// @return true si el componente existe; false en caso contrario.
+bool InventoryManager::getComponent(int id, Component &component) {
+    return shardForId(id).db->fetchComponent(id, component);
 }
 
-/// @brief Obtiene los componentes cuyo stock está por debajo o igual a un umbral.
-/// @param threshold Cantidad máxima para considerar un componente con bajo stock.
-/// @return Vector con los componentes con cantidad menor o igual al umbral.
-std::vector<Component> InventoryManager::getLowStockComponents(int threshold) {
-    std::vector<Component> all = m_dbManager.fetchAllComponents();
-    std::vector<Component> low;
-    std::copy_if(all.begin(), all.end(), std::back_inserter(low),
-                 [threshold](const Component &c) { return c.quantity() <= threshold; });
-    return low;
+/// @brief Obtiene los componentes en o por debajo de su umbral de reposición efectivo.
+/// @param threshold Umbral general para los componentes sin umbral propio ni de tipo.
+/// @param limit Número máximo de componentes (negativo sin límite).
+/// @param truncated Recibe si se ha alcanzado el límite.
+/// @return Vector con los componentes con bajo stock.
+std::vector<ComponentSummary> InventoryManager::getLowStockComponents(int threshold, int limit, bool *truncated) {
+    return gather([threshold](DatabaseManager &db, int rows) { return db.fetchLowStockComponents(threshold, rows); },
+                  limit, truncated);
+}
+
+/// @brief Obtiene los componentes comprados entre dos fechas, ordenados por fecha de compra.
+/// @param from Primera fecha incluida (no válida: sin límite inferior).
+/// @param to Última fecha incluida (no válida: sin límite superior).
+/// @param type Tipo exigido (vacío: cualquiera).
+/// @param limit Número máximo de componentes (negativo sin límite).
+/// @param truncated Recibe si se ha alcanzado el límite.
+/// @return Resúmenes ordenados por fecha de compra e ID.
+std::vector<ComponentSummary> InventoryManager::getComponentsPurchasedBetween(const QDate &from, const QDate &to,
+                                                                              const QString &type, int limit,
+                                                                              bool *truncated) {
+    return gather([from, to, type](DatabaseManager &db, int rows) {
+                      return db.fetchComponentsPurchasedBetween(from, to, type, rows);
+                  },
+                  limit, truncated, [](const ComponentSummary &a, const ComponentSummary &b) {
+                      return a.purchaseDate < b.purchaseDate || (a.purchaseDate == b.purchaseDate && a.id < b.id);
+                  });
+}
+
+/// @brief Obtiene los componentes con más de `days` días desde su compra.
+/// @param days Antigüedad mínima en días.
+/// @param type Tipo exigido (vacío: cualquiera).
+/// @param limit Número máximo de componentes (negativo sin límite).
+/// @param truncated Recibe si se ha alcanzado el límite.
+/// @return Resúmenes ordenados del más antiguo al más reciente.
+std::vector<ComponentSummary> InventoryManager::getComponentsOlderThan(int days, const QString &type, int limit,
+                                                                       bool *truncated) {
+    return getComponentsPurchasedBetween(QDate(), QDate::currentDate().addDays(-qint64(days) - 1), type, limit,
+                                         truncated);
+}
+
+/// @brief Calcula el histograma de antigüedad por tipo, en paralelo entre fragmentos.
+/// @param bounds Límites de las franjas en días.
+/// @param histogram Recibe el histograma combinado.
+/// @param today Fecha de referencia.
+/// @return true si todos los fragmentos responden; false en caso de error.
+bool InventoryManager::agingHistogram(const std::vector<int> &bounds, AgingHistogram &histogram,
+                                      const QDate &today) {
+    histogram = AgingHistogram();
+    histogram.today = today;
+    for (int bound : bounds) {
+        if (bound >= 0)
+            histogram.bounds.push_back(bound);
+    }
+    std::sort(histogram.bounds.begin(), histogram.bounds.end());
+    histogram.bounds.erase(std::unique(histogram.bounds.begin(), histogram.bounds.end()), histogram.bounds.end());
+
+    if (m_shards.size() == 1)
+        return m_shards.front().db->accumulateAgingHistogram(histogram);
+
+    flushPendingWrites();
+    const AgingHistogram empty = histogram;
+    const std::function<std::pair<bool, AgingHistogram>(DatabaseManager &)> query =
+        [empty](DatabaseManager &db) -> std::pair<bool, AgingHistogram> {
+            std::pair<bool, AgingHistogram> result(false, empty);
+            result.first = db.accumulateAgingHistogram(result.second);
+            return result;
+        };
+    std::vector<std::future<std::pair<bool, AgingHistogram>>> parts;
+    parts.reserve(m_shards.size());
+    for (Shard &shard : m_shards)
+        parts.push_back(shard.reader->run<std::pair<bool, AgingHistogram>>(query));
+
+    bool ok = true;
+    for (auto &part : parts) {
+        const std::pair<bool, AgingHistogram> shardResult = part.get();
+        ok = shardResult.first && ok;
+        histogram.add(shardResult.second);
+    }
+    return ok;
+}
+
+/// @brief Recorre los cambios confirmados de un fragmento posteriores a una secuencia.
+/// @param since Última secuencia ya procesada.
+/// @param visitor Función llamada con cada cambio.
+/// @param limit Número máximo de cambios (negativo sin límite).
+/// @param shardId Fragmento cuyo registro se lee.
+/// @return true si la lectura se ejecuta correctamente; false en caso de error.
+bool InventoryManager::forEachChangeSince(qint64 since, const std::function<bool(const ChangeRecord &)> &visitor,
+                                          int limit, int shardId) {
+    Shard *shard = findShard(shardId);
+    if (!shard || !flushPendingWrites())
+        return false;
+    return shard->db->forEachChangeSince(since, visitor, limit);
+}
+
+/// @brief Secuencia del último cambio confirmado de un fragmento.
+/// @param shardId Fragmento consultado.
+/// @return Secuencia más alta o -1 en caso de error.
+qint64 InventoryManager::latestChangeSequence(int shardId) {
+    Shard *shard = findShard(shardId);
+    if (!shard || !flushPendingWrites())
+        return -1;
+    return shard->db->latestChangeSequence();
+}
+
+/// @brief Poda el registro de cambios de un fragmento hasta la secuencia indicada.
+/// @param upToSequence Última secuencia a eliminar.
+/// @param shardId Fragmento afectado.
+/// @return true si la poda se realiza correctamente; false en caso de error.
+bool InventoryManager::pruneChanges(qint64 upToSequence, int shardId) {
+    Shard *shard = findShard(shardId);
+    if (!shard || !flushPendingWrites())
+        return false;
+    return shard->db->pruneChanges(upToSequence);
 }
 
+/// @brief Copia cada fragmento a un directorio con una instantánea consistente.
+/// @param directory Directorio destino.
+/// @param files Recibe las rutas de las copias escritas.
+/// @return true si se copian todos los fragmentos; false en caso de error.
+bool InventoryManager::backup(const QString &directory, QStringList *files) {
+    if (!flushPendingWrites())
+        return false;
+    QDir target(directory);
+    if (!target.mkpath(".")) {
+        qDebug() << "Error: no se puede crear el directorio de copia" << directory;
+        return false;
+    }
+    QStringList written;
+    for (Shard &shard : m_shards) {
+        const QString path = target.filePath(QFileInfo(shard.dbPath).fileName());
+        // Dos fragmentos con el mismo nombre de archivo se sobrescribirían entre sí
+        if (written.contains(path)) {
+            qDebug() << "Error: dos fragmentos se copiarían en" << path;
+            return false;
+        }
+        if (!shard.db->backupTo(path))
+            return false;
+        written.append(path);
+        if (files)
+            files->append(path);
+    }
+    return true;
+}
+
+/// @brief Compacta cada fragmento y actualiza las estadísticas de su planificador.
+/// @param stats Recibe el resultado de cada fragmento.
+/// @return true si el mantenimiento se completa en todos los fragmentos; false en caso de error.
+bool InventoryManager::maintain(QMap<int, MaintenanceStats> *stats) {
+    QMap<int, MaintenanceStats> results;
+    bool ok = flushPendingWrites();
+    for (Shard &shard : m_shards) {
+        if (!ok)
+            break;
+        MaintenanceStats shardStats;
+        ok = shard.db->runMaintenance(shardStats);
+        if (ok)
+            results.insert(shard.id, shardStats);
+    }
+    if (stats)
+        *stats = results;
+    emit maintenanceFinished(ok, results);
+    return ok;
+}
+
+/// @brief Programa (o desactiva) el mantenimiento periódico.
+/// @param intervalMs Intervalo entre pasadas en ms; 0 o negativo lo desactiva.
+void InventoryManager::setMaintenanceInterval(int intervalMs) {
+    if (intervalMs > 0)
+        m_maintenanceTimer.start(intervalMs);
+    else
+        m_maintenanceTimer.stop();
+}
+
+/// @brief Establece el umbral general de las alertas de bajo stock.
+/// @param threshold Nuevo umbral general.
+void InventoryManager::setDefaultLowStockThreshold(int threshold) {
+    m_monitor.setDefaultThreshold(threshold);
+}
+
+/// @brief Guarda el umbral de reposición de un tipo y lo aplica al monitor.
+/// @param type Tipo de componente.
+/// @param threshold Umbral del tipo; un valor negativo lo elimina.
+/// @return true si el umbral se guarda correctamente; false en caso de error.
+bool InventoryManager::setTypeThreshold(const QString &type, int threshold) {
+    for (Shard &shard : m_shards) {
+        if (!shard.db->setTypeThreshold(type, threshold))
+            return false;
+    }
+    m_monitor.setTypeThreshold(type, threshold);
+    return true;
+}
+
+/// @brief Umbral de reposición de un tipo.
+/// @param type Tipo de componente.
+/// @return Umbral del tipo, o -1 si no tiene.
+int InventoryManager::typeThreshold(const QString &type) const {
+    return m_monitor.typeThreshold(type);
+}
+
+/// @brief Deshace la última operación del diario aplicando su imagen anterior.
+/// @return true si la operación se deshace; false si el diario está vacío o la escritura falla.
+bool InventoryManager::undo() {
+    // Se confirma aparte, para no mover la entrada si la escritura acaba descartándose
+    if (!flushPendingWrites() || m_undoStack.empty())
+        return false;
+    JournalEntry entry = m_undoStack.back();
+    bool ok = false;
+    switch (entry.operation) {
+    case JournalEntry::Add:
+        ok = applyRemove(entry.after.id());
+        break;
+    case JournalEntry::Update:
+        ok = applyUpdate(&entry.after, entry.before);
+        break;
+    case JournalEntry::Remove:
+        ok = applyRestore(entry.before);
+        break;
+    }
+    if (!ok || !flushPendingWrites())
+        return false;
+    m_undoStack.pop_back();
+    m_redoStack.push_back(entry);
+    updateJournalUsage();
+    emit undoRedoChanged(canUndo(), canRedo());
+    return true;
+}
+
+/// @brief Rehace la última operación deshecha aplicando su imagen posterior.
+/// @return true si la operación se rehace; false si no hay nada que rehacer o la escritura falla.
+bool InventoryManager::redo() {
+    if (!flushPendingWrites() || m_redoStack.empty())
+        return false;
+    JournalEntry entry = m_redoStack.back();
+    bool ok = false;
+    switch (entry.operation) {
+    case JournalEntry::Add:
+        ok = applyRestore(entry.after);
+        break;
+    case JournalEntry::Update:
+        ok = applyUpdate(&entry.before, entry.after);
+        break;
+    case JournalEntry::Remove:
+        ok = applyRemove(entry.before.id());
+        break;
+    }
+    if (!ok || !flushPendingWrites())
+        return false;
+    m_redoStack.pop_back();
+    entry.timestamp = -1; // una operación rehecha no se fusiona con ediciones posteriores
+    entry.pendingShard = -1;
+    m_undoStack.push_back(entry);
+    updateJournalUsage();
+    emit undoRedoChanged(canUndo(), canRedo());
+    return true;
+}
+
+/// @brief Indica si hay operaciones que deshacer.
+/// @return true si el diario no está vacío.
+bool InventoryManager::canUndo() const {
+    return !m_undoStack.empty();
+}
+
+/// @brief Indica si hay operaciones que rehacer.
+/// @return true si hay operaciones deshechas.
+bool InventoryManager::canRedo() const {
+    return !m_redoStack.empty();
+}
+
+/// @brief Configura la agrupación de escrituras en transacciones.
+/// @param intervalMs Ventana máxima de agrupación en ms; 0 confirma cada escritura de inmediato.
+/// @param maxPendingWrites Escrituras que fuerzan la confirmación (mínimo 1).
+void InventoryManager::setWriteCoalescing(int intervalMs, int maxPendingWrites) {
+    m_coalesceIntervalMs = intervalMs < 0 ? 0 : intervalMs;
+    m_maxPendingWrites = maxPendingWrites < 1 ? 1 : maxPendingWrites;
+    if (m_coalesceIntervalMs == 0)
+        flushPendingWrites();
+}
+
+/// @brief Confirma las transacciones agrupadas abiertas en los fragmentos.
+/// @return true si no hay transacciones abiertas o se confirman correctamente; false en caso de error.
+///        Una transacción que no se confirma se descarta, para que la conexión no quede dentro
+///        de ella, y sus operaciones se retiran del diario.
+bool InventoryManager::flushPendingWrites() {
+    m_flushTimer.stop();
+    m_pendingWrites = 0;
+    std::vector<int> discarded;
+    for (Shard &shard : m_shards) {
+        if (!shard.transactionOpen)
+            continue;
+        if (!shard.db->commitTransaction()) {
+            shard.db->rollbackTransaction();
+            discarded.push_back(shard.id);
+        }
+        shard.transactionOpen = false;
+    }
+
+    // Las operaciones de las transacciones confirmadas quedan firmes; las descartadas se quitan
+    bool journalChanged = false;
+    for (auto it = m_undoStack.begin(); it != m_undoStack.end();) {
+        if (it->pendingShard < 0) {
+            ++it;
+        } else if (std::find(discarded.begin(), discarded.end(), it->pendingShard) != discarded.end()) {
+            it = m_undoStack.erase(it);
+            journalChanged = true;
+        } else {
+            it->pendingShard = -1;
+            ++it;
+        }
+    }
+    if (discarded.empty())
+        return true;
+
+    // El índice de trigramas puede contener filas descartadas: se reconstruye en la próxima búsqueda
+    if (m_fuzzyIndexBuilt) {
+        m_fuzzyIndex.clear();
+        m_fuzzyIndexBuilt = false;
+        m_fuzzyIndexAccount.setUsage(0);
+    }
+    if (journalChanged) {
+        updateJournalUsage();
+        emit undoRedoChanged(canUndo(), canRedo());
+    }
+    for (int shardId : discarded)
+        emit pendingWritesDiscarded(shardId);
+    return false;
+}
+
+/// @brief Inserta un componente y evalúa sus umbrales.
+/// @param component Componente a insertar; recibe el ID asignado.
+/// @return true si la inserción tiene éxito.
+bool InventoryManager::applyAdd(Component &component) {
+    Shard &shard = shardForLocation(component.location());
+    int newId = -1;
+    beginWrite(shard);
+    const bool ok = shard.db->addComponent(component, &newId);
+    if (!endWrite() || !ok)
+        return false;
+    if (m_shards.size() > 1 && shardForId(newId).id != shard.id)
+        qDebug() << "Error: el fragmento" << shard.id << "ha agotado su rango de IDs";
+    component.setId(newId);
+    m_monitor.evaluate(nullptr, &component);
+    if (m_fuzzyIndexBuilt) {
+        m_fuzzyIndex.insert(component);
+        m_fuzzyIndexAccount.setUsage(m_fuzzyIndex.memoryUsage());
+    }
+    return true;
+}
+
+/// @brief Reinserta un componente con su ID original y evalúa sus umbrales.
+/// @param component Componente a reinsertar.
+/// @return true si la inserción tiene éxito.
+bool InventoryManager::applyRestore(const Component &component) {
+    Shard &shard = shardForId(component.id());
+    beginWrite(shard);
+    const bool ok = shard.db->restoreComponent(component);
+    if (!endWrite() || !ok)
+        return false;
+    m_monitor.evaluate(nullptr, &component);
+    if (m_fuzzyIndexBuilt) {
+        m_fuzzyIndex.insert(component);
+        m_fuzzyIndexAccount.setUsage(m_fuzzyIndex.memoryUsage());
+    }
+    return true;
+}
+
+/// @brief Escribe la imagen posterior de una fila y evalúa el cruce de umbrales.
+/// @param before Imagen previa, o nullptr si no se conoce.
+/// @param after Imagen a escribir.
+/// @return true si la actualización tiene éxito.
+bool InventoryManager::applyUpdate(const Component *before, const Component &after) {
+    Shard &shard = shardForId(after.id());
+    beginWrite(shard);
+    const bool ok = shard.db->updateComponent(after);
+    if (!endWrite() || !ok)
+        return false;
+    m_monitor.evaluate(before, &after);
+    if (m_fuzzyIndexBuilt) {
+        m_fuzzyIndex.insert(after);
+        m_fuzzyIndexAccount.setUsage(m_fuzzyIndex.memoryUsage());
+    }
+    return true;
+}
+
+/// @brief Elimina una fila por su ID.
+/// @param id Identificador del componente.
+/// @return true si la eliminación tiene éxito.
+bool InventoryManager::applyRemove(int id) {
+    Shard &shard = shardForId(id);
+    beginWrite(shard);
+    const bool ok = shard.db->removeComponent(id);
+    if (!endWrite() || !ok)
+        return false;
+    if (m_fuzzyIndexBuilt) {
+        m_fuzzyIndex.remove(id);
+        m_fuzzyIndexAccount.setUsage(m_fuzzyIndex.memoryUsage());
+    }
+    return true;
+}
+
+/// @brief Abre la transacción agrupada del fragmento si la agrupación está activa y no hay ninguna abierta.
+/// @param shard Fragmento que recibe la escritura.
+void InventoryManager::beginWrite(Shard &shard) {
+    if (m_coalesceIntervalMs == 0 || shard.transactionOpen)
+        return;
+    shard.transactionOpen = shard.db->beginTransaction();
+}
+
+/// @brief Contabiliza la escritura en las transacciones abiertas y decide cuándo confirmarlas.
+/// @return false si se fuerza la confirmación y falla (la escritura se ha descartado).
+bool InventoryManager::endWrite() {
+    if (m_coalesceIntervalMs == 0)
+        return true;
+    if (++m_pendingWrites >= m_maxPendingWrites)
+        return flushPendingWrites();
+    if (!m_flushTimer.isActive())
+        m_flushTimer.start(m_coalesceIntervalMs);
+    return true;
+}
+
+/// @brief Fragmento de la fila afectada por una operación del diario.
+/// @param entry Operación del diario.
+/// @return Fragmento que posee la fila.
+InventoryManager::Shard &InventoryManager::shardOf(const JournalEntry &entry) {
+    return shardForId(entry.operation == JournalEntry::Remove ? entry.before.id() : entry.after.id());
+}
+
+/// @brief Registra una operación en el diario y vacía la pila de rehacer.
+///        Las actualizaciones de la misma fila dentro de la ventana de agrupación se
+///        fusionan en una sola entrada que conserva la imagen previa original.
+/// @param entry Operación a registrar.
+void InventoryManager::record(const JournalEntry &entry) {
+    applyMemoryRequests();
+    const qint64 now = m_journalClock.elapsed();
+    const qint64 window = m_coalesceIntervalMs;
+    // Una escritura dentro de una transacción agrupada queda pendiente hasta confirmarla
+    const Shard &shard = shardOf(entry);
+    const int pendingShard = shard.transactionOpen ? shard.id : -1;
+    if (window > 0 && entry.operation == JournalEntry::Update
+        && !m_undoStack.empty() && m_redoStack.empty()) {
+        JournalEntry &last = m_undoStack.back();
+        // Solo se fusiona con una entrada en el mismo estado: si se descarta la transacción,
+        // no debe quedar en el diario una imagen posterior que no llegó a escribirse
+        if (last.operation == JournalEntry::Update
+            && last.after.id() == entry.after.id()
+            && last.pendingShard == pendingShard
+            && last.timestamp >= 0 && now - last.timestamp <= window) {
+            last.after = entry.after;
+            last.timestamp = now;
+            updateJournalUsage();
+            return;
+        }
+    }
+
+    JournalEntry stored = entry;
+    stored.timestamp = now;
+    stored.pendingShard = pendingShard;
+    m_undoStack.push_back(stored);
+    if (m_undoStack.size() > kMaxJournalEntries)
+        m_undoStack.pop_front();
+    m_redoStack.clear();
+    updateJournalUsage();
+    emit undoRedoChanged(canUndo(), canRedo());
+}
+
+/// @brief Descarta el índice de trigramas o la mitad más antigua del diario si el presupuesto
+///        de memoria lo ha pedido. Las peticiones llegan desde cualquier hilo y se atienden aquí,
+///        en el hilo del gestor.
+void InventoryManager::applyMemoryRequests() {
+    if (m_evictFuzzyIndex.exchange(false) && m_fuzzyIndexBuilt) {
+        m_fuzzyIndex.clear();
+        m_fuzzyIndexBuilt = false;
+        m_fuzzyIndexAccount.setUsage(0);
+    }
+    if (m_trimJournal.exchange(false) && !m_undoStack.empty()) {
+        m_undoStack.erase(m_undoStack.begin(), m_undoStack.begin() + (m_undoStack.size() + 1) / 2);
+        updateJournalUsage();
+        emit undoRedoChanged(canUndo(), canRedo());
+    }
+}
+
+/// @brief Calcula los bytes del diario (imágenes anterior y posterior de cada entrada).
+void InventoryManager::updateJournalUsage() {
+    qint64 bytes = 0;
+    const auto add = [&bytes](const JournalEntry &entry) {
+        bytes += qint64(sizeof(JournalEntry)) - 2 * qint64(sizeof(Component))
+                 + MemoryBudget::estimate(entry.before) + MemoryBudget::estimate(entry.after);
+    };
+    for (const JournalEntry &entry : m_undoStack)
+        add(entry);
+    for (const JournalEntry &entry : m_redoStack)
+        add(entry);
+    m_journalAccount.setUsage(bytes);
+}
+
+/// @brief Fragmento propietario de un ID según su rango.
+/// @param id Identificador del componente.
+/// @return Fragmento del rango, o el fragmento 0 si no está registrado.
+InventoryManager::Shard &InventoryManager::shardForId(int id) {
+    Shard *shard = findShard(int(id / kShardIdSpan));
+    return shard ? *shard : m_shards.front();
+}
+
+/// @brief Fragmento del almacén de una ubicación.
+/// @param location Ubicación del componente.
+/// @return Fragmento del almacén, o el fragmento 0.
+InventoryManager::Shard &InventoryManager::shardForLocation(const QString &location) {
+    if (m_shards.size() > 1) {
+        const QString warehouse = warehouseOf(location);
+        for (Shard &shard : m_shards) {
+            if (!warehouse.isEmpty() && shard.warehouse == warehouse)
+                return shard;
+        }
+    }
+    return m_shards.front();
+}
+
+/// @brief Busca un fragmento por su número.
+/// @param shardId Número del fragmento.
+/// @return Puntero al fragmento, o nullptr si no existe.
+InventoryManager::Shard *InventoryManager::findShard(int shardId) {
+    for (Shard &shard : m_shards) {
+        if (shard.id == shardId)
+            return &shard;
+    }
+    return nullptr;
+}
+
+/// @brief Reparte una consulta entre los hilos lectores de los fragmentos y concatena los resultados.
+///        Antes se confirman las escrituras agrupadas, porque los lectores usan otras conexiones.
+///        Con límite, cada fragmento lee una fila de más para detectar si el resultado se trunca.
+/// @param query Consulta a ejecutar sobre cada fragmento.
+/// @param limit Número máximo de resultados (negativo sin límite).
+/// @param truncated Recibe si se han descartado resultados.
+/// @return Resultados combinados en orden de fragmento.
+std::vector<ComponentSummary> InventoryManager::gather(
+    const std::function<std::vector<ComponentSummary>(DatabaseManager &, int)> &query, int limit, bool *truncated,
+    const std::function<bool(const ComponentSummary &, const ComponentSummary &)> &order) {
+    applyMemoryRequests();
+    const int rows = limit < 0 ? -1 : limit + 1;
+    std::vector<ComponentSummary> merged;
+    if (m_shards.size() == 1) {
+        merged = query(*m_shards.front().db, rows);
+    } else {
+        flushPendingWrites();
+        const std::function<std::vector<ComponentSummary>(DatabaseManager &)> bounded =
+            [query, rows](DatabaseManager &db) { return query(db, rows); };
+        std::vector<std::future<std::vector<ComponentSummary>>> parts;
+        parts.reserve(m_shards.size());
+        for (Shard &shard : m_shards)
+            parts.push_back(shard.reader->run<std::vector<ComponentSummary>>(bounded));
+
+        for (auto &part : parts) {
+            std::vector<ComponentSummary> shardRows = part.get();
+            merged.insert(merged.end(), shardRows.begin(), shardRows.end());
+        }
+        if (order)
+            std::stable_sort(merged.begin(), merged.end(), order);
+    }
+
+    const bool cut = limit >= 0 && merged.size() > std::size_t(limit);
+    if (cut)
+        merged.resize(std::size_t(limit));
+    if (truncated)
+        *truncated = cut;
+    return merged;
+}
@@ -5,16 +5,54 @@
 #define INVENTORYMANAGER_H
 
 #include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QMap>
+#include <QHash>
+#include <QStringList>
+#include <atomic>
+#include <deque>
+#include <memory>
 #include <vector>
 #include "Component.h"
 #include "DatabaseManager.h"
+#include "LowStockMonitor.h"
+#include "FuzzyIndex.h"
+#include "MemoryBudget.h"
+
+class ShardReader;
+
+/// @struct ShardSpec
+/// @brief Configuración de un fragmento (base de datos) dedicado a un almacén.
+struct ShardSpec {
+    int id;            ///< Número del fragmento (1-127); fija su rango de IDs y no debe cambiar.
+    QString warehouse; ///< Almacén cuyos componentes se guardan en el fragmento.
+    QString dbPath;    ///< Ruta de la base de datos del fragmento.
+};
 
 /// @class InventoryManager
 /// @brief Clase que actúa como capa intermedia entre la interfaz de usuario y la base de datos.
 ///
 /// Esta clase utiliza DatabaseManager para realizar operaciones de inventario
 /// como obtención, búsqueda, adición, actualización, eliminación y detección
-/// de componentes con bajo stock.
+/// de componentes con bajo stock. Cada escritura se evalúa contra los umbrales
+/// de reposición y, si cruza alguno, se emite lowStockAlert().
+///
+/// Las operaciones de escritura se registran en un diario con la imagen anterior
+/// y posterior de cada fila, lo que permite deshacerlas y rehacerlas. Si se activa
+/// la agrupación de escrituras, las operaciones consecutivas comparten una única
+/// transacción que se confirma por temporizador o al alcanzar un número máximo
+/// de escrituras pendientes.
+///
+/// El inventario puede repartirse en fragmentos, uno por almacén (ver addShard()). La
+/// base de datos de initialize() es el fragmento 0 y recibe los componentes sin almacén
+/// registrado. Cada fragmento asigna IDs de su propio rango, así que el ID identifica el
+/// fragmento que posee la fila: las escrituras van solo a ese fragmento y las lecturas
+/// de todo el inventario se reparten en paralelo entre los fragmentos y se combinan.
+///
+/// El índice de trigramas y el diario se contabilizan en MemoryBudget como cachés: si se
+/// supera el presupuesto, el índice se descarta (se reconstruye en la siguiente búsqueda
+/// aproximada) y el diario pierde su mitad más antigua.
 class InventoryManager : public QObject {
     Q_OBJECT
 
@@ -28,39 +66,404 @@ public:
 
     /// @brief Inicializa el gestor de inventario abriendo la base de datos.
     /// @param dbPath Ruta al archivo de la base de datos SQLite.
+    /// @param connectionName Nombre de la conexión Qt; cada hilo debe usar un gestor y un nombre propios.
     /// @return true si la inicialización (apertura de la base y creación de tablas) es exitosa; false en caso de error.
-    bool initialize(const QString &dbPath);
+    bool initialize(const QString &dbPath,
+                    const QString &connectionName = "qt_inventory_connection");
+
+    /// @brief Añade el fragmento de un almacén. Debe llamarse después de initialize().
+    ///
+    /// Los componentes nuevos cuya ubicación empieza por "ALMACEN/" se guardan en el
+    /// fragmento de ese almacén. Un componente permanece en su fragmento aunque después
+    /// cambie de ubicación. Cada fragmento es un archivo independiente y puede copiarse
+    /// o respaldarse por separado.
+    /// @param spec Número, almacén y ruta del fragmento.
+    /// @return true si el fragmento se abre, migra y sus IDs están en su rango; false en caso de error.
+    bool addShard(const ShardSpec &spec);
+
+    /// @brief Interpreta una especificación de fragmento con el formato "id:ALMACEN=ruta".
+    /// @param text Texto a interpretar (p. ej. "1:BOG=bogota.db").
+    /// @param spec Recibe la configuración si el texto es válido.
+    /// @return true si el texto es válido.
+    static bool parseShardSpec(const QString &text, ShardSpec &spec);
 
-    /// @brief Obtiene todos los componentes del inventario.
-    /// @return Vector con los objetos Component representando cada registro de la base.
-    std::vector<Component> getAllComponents();
+    /// @brief Almacén al que pertenece una ubicación (el prefijo antes de la primera '/').
+    /// @param location Ubicación del componente.
+    /// @return Nombre del almacén, o cadena vacía si la ubicación no indica ninguno.
+    static QString warehouseOf(const QString &location);
+
+    /// @brief Rutas de las bases de datos de todos los fragmentos, por número de fragmento.
+    /// @return Tabla número → ruta (el fragmento 0 es la base de datos de initialize()).
+    QMap<int, QString> shardDatabasePaths() const;
+
+    /// @brief Lanza en segundo plano los rellenos e índices pendientes de las migraciones del esquema.
+    ///        El avance se notifica con migrationProgress() y el final con migrationsFinished(),
+    ///        que se emiten una vez por fragmento.
+    void startBackgroundMigrations();
+
+    /// @brief Obtiene el resumen de todos los componentes del inventario (sin campos de detalle).
+    /// @param limit Número máximo de componentes; negativo sin límite.
+    /// @param truncated Si no es nullptr, recibe true si había más componentes que el límite.
+    /// @return Vector con el resumen de cada registro de la base.
+    std::vector<ComponentSummary> getAllComponents(int limit = -1, bool *truncated = nullptr);
+
+    /// @brief Recorre todos los componentes sin materializarlos en un vector.
+    /// @param visitor Función llamada con cada componente; si devuelve false se detiene el recorrido.
+    /// @return true si el recorrido se ejecuta correctamente; false en caso de error.
+    bool forEachComponent(const std::function<bool(const Component &)> &visitor);
 
     /// @brief Busca componentes cuyo nombre, tipo o ubicación contenga la palabra clave.
     /// @param keyword Cadena utilizada para filtrar la búsqueda.
-    /// @return Vector con los objetos Component que coinciden con el criterio de búsqueda.
-    std::vector<Component> searchComponents(const QString &keyword);
+    /// @param limit Número máximo de componentes; negativo sin límite.
+    /// @param truncated Si no es nullptr, recibe true si había más coincidencias que el límite.
+    /// @return Resúmenes de los componentes que coinciden con el criterio de búsqueda.
+    std::vector<ComponentSummary> searchComponents(const QString &keyword, int limit = -1, bool *truncated = nullptr);
+
+    /// @brief Busca componentes de forma aproximada, tolerando errores tipográficos.
+    ///
+    /// Usa un índice de trigramas en memoria que se construye en la primera llamada.
+    /// Antes de cada búsqueda aplica los cambios que la tabla `changes` registró desde
+    /// la anterior, incluidos los de otras conexiones a la misma base de datos.
+    /// @param query Texto buscado.
+    /// @param topK Número máximo de resultados (por defecto 20).
+    /// @return Resúmenes ordenados por relevancia descendente.
+    std::vector<ComponentSummary> fuzzySearch(const QString &query, int topK = 20);
 
     /// @brief Agrega un nuevo componente al inventario.
     /// @param component Objeto Component con los datos del nuevo componente.
+    /// @param newId Si no es nullptr, recibe el ID asignado al componente.
     /// @return true si la operación se completa correctamente; false en caso de error.
-    bool addComponent(const Component &component);
+    bool addComponent(const Component &component, int *newId = nullptr);
     /// @brief Actualiza los datos de un componente existente en el inventario.
     /// @param component Objeto Component con el ID y los nuevos datos.
-    /// @return true si la actualización se realiza correctamente; false en caso de error.
+    /// @return true si la actualización se realiza correctamente; false si el componente no existe o hay un error.
     bool updateComponent(const Component &component);
 
+    /// @brief Suma o resta unidades al stock de un componente sin reescribir el resto de campos.
+    ///
+    /// El ajuste es atómico en la base de datos, por lo que ajustes concurrentes desde
+    /// varias conexiones no se pisan entre sí.
+    /// @param id Identificador del componente.
+    /// @param delta Unidades a sumar (negativo para restar).
+    /// @return true si el ajuste se realiza correctamente; false en caso de error.
+    bool adjustQuantity(int id, int delta);
+
+    /// @brief Aplica un lote de ajustes de stock en una transacción por fragmento.
+    ///
+    /// Pensado para recuentos con lector de códigos: cientos de ajustes se confirman
+    /// juntos. Cada ajuste se registra en el diario y se evalúa contra los umbrales.
+    /// El lote de un fragmento se aplica entero o no se aplica: si un ajuste falla (p. ej.
+    /// porque el ID ya no existe) o la confirmación falla, se descarta su transacción.
+    /// @param deltas Unidades a sumar por ID de componente.
+    /// @param failed Si no es nullptr, recibe los ajustes de los fragmentos cuya transacción se
+    ///        descarta, que no se han aplicado y pueden reintentarse.
+    /// @return true si todas las transacciones se confirman; false en caso de error.
+    bool adjustQuantities(const QHash<int, int> &deltas, QHash<int, int> *failed = nullptr);
+
+    /// @brief Resuelve un código de barras en todos los fragmentos.
+    /// @param barcode Código leído.
+    /// @param id Recibe el ID del componente.
+    /// @return true si algún componente tiene asignado el código.
+    bool componentIdForBarcode(const QString &barcode, int &id);
+
     /// @brief Elimina un componente del inventario según su ID.
     /// @param id Identificador del componente a eliminar.
     /// @return true si la eliminación es exitosa; false en caso de error.
     bool removeComponent(int id);
 
-    /// @brief Obtiene los componentes cuyo stock está por debajo de un umbral.
-    /// @param threshold Cantidad mínima aceptable antes de considerarse bajo stock.
-    /// @return Vector con los objetos Component que tienen cantidad menor al umbral.
-    std::vector<Component> getLowStockComponents(int threshold);
+    /// @brief Obtiene un componente por su ID con todos sus campos de detalle (notas, hoja de datos).
+    /// @param id Identificador del componente.
+    /// @param component Objeto que recibe los datos del componente.
+    /// @return true si el componente existe; false en caso contrario.
+    bool getComponent(int id, Component &component);
+
+    /// @brief Obtiene los componentes cuyo stock está en o por debajo de su umbral de reposición.
+    /// @param threshold Umbral general, usado cuando ni el componente ni su tipo definen uno.
+    /// @param limit Número máximo de componentes; negativo sin límite.
+    /// @param truncated Si no es nullptr, recibe true si había más componentes que el límite.
+    /// @return Resúmenes de los componentes con bajo stock.
+    std::vector<ComponentSummary> getLowStockComponents(int threshold, int limit = -1, bool *truncated = nullptr);
+
+    /// @brief Obtiene los componentes comprados en un intervalo de fechas (p. ej. para auditorías).
+    ///        El resultado está ordenado por fecha de compra, también entre fragmentos.
+    /// @param from Primera fecha incluida (no válida: sin límite inferior).
+    /// @param to Última fecha incluida (no válida: sin límite superior).
+    /// @param type Si no está vacío, solo los componentes de este tipo.
+    /// @param limit Número máximo de componentes; negativo sin límite.
+    /// @param truncated Si no es nullptr, recibe true si había más componentes que el límite.
+    /// @return Resúmenes de los componentes del intervalo.
+    std::vector<ComponentSummary> getComponentsPurchasedBetween(const QDate &from, const QDate &to,
+                                                                const QString &type = QString(), int limit = -1,
+                                                                bool *truncated = nullptr);
+
+    /// @brief Obtiene los componentes comprados hace más de un número de días, del más antiguo al más reciente.
+    /// @param days Antigüedad mínima en días (se excluyen los comprados hace exactamente `days` días).
+    /// @param type Si no está vacío, solo los componentes de este tipo.
+    /// @param limit Número máximo de componentes; negativo sin límite.
+    /// @param truncated Si no es nullptr, recibe true si había más componentes que el límite.
+    /// @return Resúmenes de los componentes más antiguos que `days`.
+    std::vector<ComponentSummary> getComponentsOlderThan(int days, const QString &type = QString(), int limit = -1,
+                                                         bool *truncated = nullptr);
+
+    /// @brief Calcula el histograma de antigüedad por tipo de todo el inventario.
+    ///        Recorre todos los componentes (por el índice, sin leer la tabla), así que está
+    ///        pensado para informes y no para consultas frecuentes.
+    /// @param bounds Límites de las franjas en días (se ordenan y se descartan negativos y repetidos).
+    /// @param histogram Recibe el histograma, sumado entre fragmentos.
+    /// @param today Fecha de referencia (por defecto, la actual).
+    /// @return true si la consulta se ejecuta en todos los fragmentos; false en caso de error.
+    bool agingHistogram(const std::vector<int> &bounds, AgingHistogram &histogram,
+                        const QDate &today = QDate::currentDate());
+
+    /// @brief Recorre los cambios del inventario posteriores a una secuencia (sincronización incremental).
+    ///
+    /// Antes de leer se confirman las escrituras agrupadas pendientes, de modo que solo se
+    /// entregan cambios ya persistidos. El coste es proporcional al número de cambios.
+    /// Cada fragmento tiene su propio registro y su propia secuencia.
+    /// @param since Última secuencia ya procesada (0 para todo el historial).
+    /// @param visitor Función llamada con cada cambio; si devuelve false se detiene el recorrido.
+    /// @param limit Número máximo de cambios (negativo sin límite).
+    /// @param shardId Fragmento cuyo registro se lee (por defecto el 0).
+    /// @return true si la lectura se ejecuta correctamente; false en caso de error o fragmento desconocido.
+    bool forEachChangeSince(qint64 since, const std::function<bool(const ChangeRecord &)> &visitor,
+                            int limit = -1, int shardId = 0);
+
+    /// @brief Secuencia del último cambio registrado en un fragmento.
+    /// @param shardId Fragmento consultado (por defecto el 0).
+    /// @return Secuencia más alta (0 si no hay cambios) o -1 en caso de error.
+    qint64 latestChangeSequence(int shardId = 0);
+
+    /// @brief Elimina de un fragmento los cambios ya consumidos por todos los destinatarios.
+    /// @param upToSequence Última secuencia a eliminar.
+    /// @param shardId Fragmento afectado (por defecto el 0).
+    /// @return true si la operación se realiza correctamente; false en caso de error.
+    bool pruneChanges(qint64 upToSequence, int shardId = 0);
+
+    /// @brief Copia en línea todos los fragmentos a un directorio.
+    ///
+    /// Cada fragmento se copia con una instantánea consistente de su base de datos y con
+    /// el mismo nombre de archivo que el original, sin detener las escrituras de otras
+    /// conexiones ni de otros procesos. Antes se confirman las escrituras agrupadas.
+    /// @param directory Directorio destino (se crea si no existe).
+    /// @param files Si no es nullptr, recibe las rutas de las copias escritas.
+    /// @return true si se copian todos los fragmentos; false en caso de error.
+    bool backup(const QString &directory, QStringList *files = nullptr);
+
+    /// @brief Compacta los archivos de todos los fragmentos y actualiza sus estadísticas.
+    ///        Al terminar se emite maintenanceFinished().
+    /// @param stats Si no es nullptr, recibe el resultado de cada fragmento por número.
+    /// @return true si el mantenimiento se completa en todos los fragmentos; false en caso de error.
+    bool maintain(QMap<int, MaintenanceStats> *stats = nullptr);
+
+    /// @brief Programa el mantenimiento periódico de los fragmentos.
+    /// @param intervalMs Intervalo entre pasadas en ms; 0 desactiva el mantenimiento programado.
+    void setMaintenanceInterval(int intervalMs);
+
+    /// @brief Establece el umbral general usado por las alertas de bajo stock.
+    /// @param threshold Cantidad máxima para considerar un componente con bajo stock.
+    void setDefaultLowStockThreshold(int threshold);
+
+    /// @brief Guarda el umbral de reposición de un tipo de componente.
+    /// @param type Tipo de componente.
+    /// @param threshold Umbral del tipo; un valor negativo lo elimina.
+    /// @return true si el umbral se guarda correctamente; false en caso de error.
+    bool setTypeThreshold(const QString &type, int threshold);
+
+    /// @brief Obtiene el umbral de reposición de un tipo de componente.
+    /// @param type Tipo de componente.
+    /// @return Umbral del tipo, o -1 si el tipo usa el umbral general.
+    int typeThreshold(const QString &type) const;
+
+    /// @brief Deshace la última operación de escritura registrada en el diario.
+    /// @return true si se deshace una operación; false si no hay nada que deshacer o hay un error.
+    bool undo();
+
+    /// @brief Rehace la última operación deshecha.
+    /// @return true si se rehace una operación; false si no hay nada que rehacer o hay un error.
+    bool redo();
+
+    /// @brief Indica si hay operaciones que deshacer.
+    /// @return true si el diario contiene operaciones deshacibles.
+    bool canUndo() const;
+
+    /// @brief Indica si hay operaciones que rehacer.
+    /// @return true si hay operaciones deshechas pendientes de rehacer.
+    bool canRedo() const;
+
+    /// @brief Configura la agrupación de escrituras en transacciones.
+    ///
+    /// Las escrituras agrupadas son visibles de inmediato para esta conexión, pero
+    /// se pierden si el proceso termina de forma abrupta antes de confirmarse.
+    /// @param intervalMs Tiempo máximo (ms) que una escritura permanece sin confirmar; 0 desactiva la agrupación.
+    /// @param maxPendingWrites Número de escrituras que fuerza la confirmación inmediata.
+    void setWriteCoalescing(int intervalMs, int maxPendingWrites);
+
+    /// @brief Confirma las transacciones agrupadas en curso de todos los fragmentos, si las hay.
+    ///        Si la confirmación de un fragmento falla, su transacción se descarta, se quitan
+    ///        del diario las operaciones que contenía y se emite pendingWritesDiscarded().
+    /// @return true si no había transacciones o se confirman correctamente; false en caso de error.
+    bool flushPendingWrites();
+
+signals:
+    /// @brief Informa del avance de una migración del esquema en segundo plano.
+    /// @param version Versión del esquema que se está aplicando.
+    /// @param done Trabajo completado en la fase en curso.
+    /// @param total Trabajo total de la fase en curso.
+    void migrationProgress(int version, qint64 done, qint64 total);
+
+    /// @brief Se emite al terminar las migraciones en segundo plano.
+    /// @param ok true si se completan sin errores.
+    void migrationsFinished(bool ok);
+
+    /// @brief Se emite cuando cambia la disponibilidad de deshacer o rehacer.
+    /// @param canUndo true si hay operaciones que deshacer.
+    /// @param canRedo true si hay operaciones que rehacer.
+    void undoRedoChanged(bool canUndo, bool canRedo);
+
+    /// @brief Se emite cuando no se puede confirmar la transacción agrupada de un fragmento y
+    ///        sus escrituras se descartan (ya no están en la base de datos ni en el diario).
+    /// @param shardId Número del fragmento.
+    void pendingWritesDiscarded(int shardId);
+
+    /// @brief Se emite cuando una escritura deja un componente en o por debajo de su umbral.
+    /// @param component Estado del componente tras la escritura.
+    /// @param threshold Umbral efectivo que se ha cruzado.
+    void lowStockAlert(const Component &component, int threshold);
+
+    /// @brief Se emite cuando una escritura repone un componente que estaba con bajo stock.
+    /// @param component Estado del componente tras la escritura.
+    /// @param threshold Umbral efectivo del componente.
+    void stockReplenished(const Component &component, int threshold);
+
+    /// @brief Se emite al terminar una pasada de mantenimiento.
+    /// @param ok true si el mantenimiento se completa en todos los fragmentos.
+    /// @param stats Resultado de cada fragmento por número.
+    void maintenanceFinished(bool ok, const QMap<int, MaintenanceStats> &stats);
 
 private:
-    DatabaseManager m_dbManager;  ///< Gestor de la base de datos subyacente.
+    /// @struct JournalEntry
+    /// @brief Operación registrada en el diario con sus imágenes anterior y posterior.
+    struct JournalEntry {
+        /// @brief Tipo de operación registrada.
+        enum Operation { Add, Update, Remove };
+        Operation operation;  ///< Tipo de operación.
+        Component before;     ///< Estado previo de la fila (no aplica en Add).
+        Component after;      ///< Estado posterior de la fila (no aplica en Remove).
+        qint64 timestamp;     ///< Instante (ms desde el arranque del diario) de la última escritura.
+        int pendingShard;     ///< Fragmento cuya transacción agrupada sin confirmar contiene la escritura (-1: confirmada).
+    };
+
+    /// @struct Shard
+    /// @brief Fragmento abierto: su conexión de escritura y, si hay varios, su hilo lector.
+    struct Shard {
+        int id;                                  ///< Número del fragmento.
+        QString warehouse;                       ///< Almacén (vacío en el fragmento 0).
+        QString dbPath;                          ///< Ruta de la base de datos.
+        QString connectionName;                  ///< Conexión de escritura (hilo del gestor).
+        DatabaseManager *db;                     ///< Gestor de la conexión de escritura.
+        std::unique_ptr<DatabaseManager> owned;  ///< Gestor propio (nullptr en el fragmento 0).
+        std::unique_ptr<ShardReader> reader;     ///< Hilo lector para lecturas en paralelo.
+        bool transactionOpen;                    ///< Hay una transacción agrupada abierta.
+        qint64 indexedSequence;                  ///< Último cambio del registro aplicado al índice de trigramas.
+    };
+
+    /// @brief Fragmento que posee un ID (según su rango de IDs).
+    /// @param id Identificador del componente.
+    /// @return Fragmento propietario, o el fragmento 0 si el rango no está registrado.
+    Shard &shardForId(int id);
+
+    /// @brief Fragmento donde se crea un componente según el almacén de su ubicación.
+    /// @param location Ubicación del componente.
+    /// @return Fragmento del almacén, o el fragmento 0 si no está registrado.
+    Shard &shardForLocation(const QString &location);
+
+    /// @brief Fragmento con un número concreto.
+    /// @param shardId Número del fragmento.
+    /// @return Puntero al fragmento, o nullptr si no existe.
+    Shard *findShard(int shardId);
+
+    /// @brief Ejecuta una consulta en todos los fragmentos en paralelo y concatena los resultados.
+    ///        Con un único fragmento la consulta se ejecuta directamente en la conexión del gestor.
+    /// @param query Consulta a ejecutar sobre cada fragmento; recibe el límite de filas a leer.
+    /// @param limit Número máximo de resultados combinados; negativo sin límite.
+    /// @param truncated Si no es nullptr, recibe true si se han descartado resultados por el límite.
+    /// @param order Si se indica, orden de los resultados combinados; cada fragmento debe
+    ///        devolverlos ya en ese orden para que el límite conserve los primeros del total.
+    /// @return Resultados de todos los fragmentos, en orden de fragmento o en el orden indicado.
+    std::vector<ComponentSummary> gather(
+        const std::function<std::vector<ComponentSummary>(DatabaseManager &, int)> &query, int limit, bool *truncated,
+        const std::function<bool(const ComponentSummary &, const ComponentSummary &)> &order =
+            std::function<bool(const ComponentSummary &, const ComponentSummary &)>());
+
+    /// @brief Inserta un componente, le asigna su ID y evalúa sus umbrales.
+    /// @param component Componente a insertar; recibe el ID asignado.
+    /// @return true si la inserción se realiza correctamente.
+    bool applyAdd(Component &component);
+
+    /// @brief Reinserta un componente con su ID original y evalúa sus umbrales.
+    /// @param component Componente a reinsertar.
+    /// @return true si la inserción se realiza correctamente.
+    bool applyRestore(const Component &component);
+
+    /// @brief Escribe la imagen posterior de una fila y evalúa el cruce de umbrales.
+    /// @param before Imagen previa (nullptr si no se conoce).
+    /// @param after Imagen que se escribe.
+    /// @return true si la actualización se realiza correctamente.
+    bool applyUpdate(const Component *before, const Component &after);
+
+    /// @brief Elimina una fila por su ID.
+    /// @param id Identificador del componente.
+    /// @return true si la eliminación se realiza correctamente.
+    bool applyRemove(int id);
+
+    /// @brief Abre la transacción agrupada del fragmento antes de una escritura si la agrupación está activa.
+    /// @param shard Fragmento que recibe la escritura.
+    void beginWrite(Shard &shard);
+
+    /// @brief Contabiliza una escritura y programa o fuerza la confirmación de la transacción.
+    /// @return false si la confirmación forzada falla y la escritura se ha descartado.
+    bool endWrite();
+
+    /// @brief Fragmento que posee la fila de una operación del diario.
+    /// @param entry Operación del diario.
+    /// @return Fragmento propietario.
+    Shard &shardOf(const JournalEntry &entry);
+
+    /// @brief Añade una operación al diario, fusionando actualizaciones rápidas de la misma fila.
+    /// @param entry Operación a registrar.
+    void record(const JournalEntry &entry);
+
+    /// @brief Construye el índice de trigramas o lo pone al día con el registro de cambios.
+    void syncFuzzyIndex();
+
+    /// @brief Atiende las peticiones de descarte del presupuesto de memoria.
+    void applyMemoryRequests();
+
+    /// @brief Declara al presupuesto los bytes que ocupa el diario.
+    void updateJournalUsage();
+
+    DatabaseManager m_dbManager;  ///< Gestor de la base de datos del fragmento 0.
+    std::vector<Shard> m_shards;  ///< Fragmentos abiertos; el primero es el fragmento 0.
+    QString m_connectionName;     ///< Conexión del fragmento 0; base de los nombres de los demás.
+    LowStockMonitor m_monitor;    ///< Motor de alertas de bajo stock.
+    FuzzyIndex m_fuzzyIndex;      ///< Índice de trigramas para búsqueda aproximada.
+    bool m_fuzzyIndexBuilt;       ///< Indica si el índice de trigramas ya se ha construido.
+
+    std::deque<JournalEntry> m_undoStack;  ///< Operaciones que se pueden deshacer (la última al final).
+    std::vector<JournalEntry> m_redoStack; ///< Operaciones deshechas que se pueden rehacer.
+    QElapsedTimer m_journalClock;          ///< Reloj para fusionar ediciones consecutivas.
+
+    std::atomic<bool> m_evictFuzzyIndex;   ///< El presupuesto ha pedido descartar el índice de trigramas.
+    std::atomic<bool> m_trimJournal;       ///< El presupuesto ha pedido recortar el diario.
+    MemoryAccount m_fuzzyIndexAccount;     ///< Memoria del índice de trigramas.
+    MemoryAccount m_journalAccount;        ///< Memoria del diario de deshacer y rehacer.
+
+    QTimer m_flushTimer;          ///< Temporizador que confirma la transacción agrupada.
+    int m_coalesceIntervalMs;     ///< Ventana de agrupación en ms (0 = desactivada).
+    int m_maxPendingWrites;       ///< Escrituras que fuerzan la confirmación.
+    int m_pendingWrites;          ///< Escrituras en las transacciones abiertas.
+
+    QTimer m_maintenanceTimer;    ///< Temporizador del mantenimiento programado.
 };
 
 #endif // INVENTORYMANAGER_H
@@ -0,0 +1,72 @@
+/// @file InventoryServer.cpp
+/// @brief Implementación del servidor REST/JSON y del reparto de conexiones entre trabajadores.
+
+#include "InventoryServer.h"
+#include "ServerWorker.h"
+#include <QThread>
+#include <QDebug>
+
+/// @brief Constructor de InventoryServer.
+/// @param dbPath Ruta de la base de datos.
+/// @param workerCount Número de hilos trabajadores.
+/// @param parent Objeto padre en la jerarquía de Qt.
+InventoryServer::InventoryServer(const QString &dbPath, int workerCount, QObject *parent)
+    : QTcpServer(parent)
+    , m_dbPath(dbPath)
+    , m_workerCount(workerCount < 1 ? 1 : workerCount)
+    , m_nextWorker(0)
+{}
+
+/// @brief Destructor de InventoryServer.
+///        Cierra el socket de escucha y detiene cada hilo; los trabajadores se destruyen en su hilo.
+InventoryServer::~InventoryServer()
+{
+    close();
+    for (QThread *thread : m_threads) {
+        thread->quit();
+        thread->wait();
+        delete thread;
+    }
+}
+
+/// @brief Crea los trabajadores, cada uno en su propio hilo, y empieza a escuchar.
+/// @param address Dirección de escucha.
+/// @param port Puerto TCP.
+/// @return true si el servidor escucha correctamente; false en caso de error.
+bool InventoryServer::start(const QHostAddress &address, quint16 port)
+{
+    if (m_workers.empty()) {
+        for (int i = 0; i < m_workerCount; ++i) {
+            QThread *thread = new QThread;
+            ServerWorker *worker = new ServerWorker(m_dbPath, QString("server_worker_%1").arg(i), m_shards);
+            worker->moveToThread(thread);
+            connect(thread, &QThread::finished, worker, &QObject::deleteLater);
+            thread->start();
+            m_threads.push_back(thread);
+            m_workers.push_back(worker);
+        }
+    }
+    if (!listen(address, port)) {
+        qDebug() << "Error al iniciar el servidor:" << errorString();
+        return false;
+    }
+    return true;
+}
+
+/// @brief Configura los fragmentos que abrirá cada trabajador.
+/// @param shards Fragmentos adicionales a la base de datos principal.
+void InventoryServer::setShards(const std::vector<ShardSpec> &shards)
+{
+    m_shards = shards;
+}
+
+/// @brief Reparte el socket aceptado por turnos; el trabajador crea el QTcpSocket en su hilo.
+/// @param socketDescriptor Descriptor nativo del socket.
+void InventoryServer::incomingConnection(qintptr socketDescriptor)
+{
+    ServerWorker *worker = m_workers[m_nextWorker];
+    m_nextWorker = (m_nextWorker + 1) % m_workers.size();
+    QMetaObject::invokeMethod(worker, [worker, socketDescriptor]() {
+        worker->handleConnection(socketDescriptor);
+    }, Qt::QueuedConnection);
+}
@@ -0,0 +1,59 @@
+/// @file InventoryServer.h
+/// @brief Declaración de la clase InventoryServer, servidor REST/JSON local sobre InventoryManager.
+
+#ifndef INVENTORYSERVER_H
+#define INVENTORYSERVER_H
+
+#include <QTcpServer>
+#include <QHostAddress>
+#include <vector>
+#include "InventoryManager.h"
+
+class QThread;
+class ServerWorker;
+
+/// @class InventoryServer
+/// @brief Servidor HTTP que reparte las conexiones entre un grupo fijo de hilos trabajadores.
+///
+/// El servidor solo acepta conexiones: cada socket aceptado se entrega, por turnos, a un
+/// ServerWorker que vive en su propio hilo y atiende todas las peticiones de esa conexión.
+/// Ver ServerWorker para la lista de rutas.
+class InventoryServer : public QTcpServer {
+    Q_OBJECT
+
+public:
+    /// @brief Constructor de InventoryServer.
+    /// @param dbPath Ruta de la base de datos que abrirá cada trabajador.
+    /// @param workerCount Número de hilos trabajadores (mínimo 1).
+    /// @param parent Objeto padre en la jerarquía de Qt (por defecto nullptr).
+    InventoryServer(const QString &dbPath, int workerCount, QObject *parent = nullptr);
+
+    /// @brief Destructor de InventoryServer.
+    ///        Detiene los hilos trabajadores y espera a que terminen.
+    ~InventoryServer();
+
+    /// @brief Arranca los hilos trabajadores y empieza a escuchar.
+    /// @param address Dirección local de escucha (por defecto solo localhost).
+    /// @param port Puerto TCP.
+    /// @return true si el servidor queda escuchando; false en caso de error.
+    bool start(const QHostAddress &address, quint16 port);
+
+    /// @brief Configura los fragmentos por almacén que abrirá cada trabajador (antes de start()).
+    /// @param shards Fragmentos adicionales a la base de datos principal.
+    void setShards(const std::vector<ShardSpec> &shards);
+
+protected:
+    /// @brief Entrega el socket aceptado al siguiente trabajador.
+    /// @param socketDescriptor Descriptor nativo del socket aceptado.
+    void incomingConnection(qintptr socketDescriptor) override;
+
+private:
+    QString m_dbPath;                       ///< Ruta de la base de datos.
+    std::vector<ShardSpec> m_shards;        ///< Fragmentos por almacén.
+    int m_workerCount;                      ///< Número de trabajadores.
+    std::vector<QThread *> m_threads;       ///< Hilos de los trabajadores.
+    std::vector<ServerWorker *> m_workers;  ///< Trabajadores (uno por hilo).
+    std::size_t m_nextWorker;               ///< Siguiente trabajador en el reparto por turnos.
+};
+
+#endif // INVENTORYSERVER_H
@@ -0,0 +1,305 @@
+/// @file LoadGenerator.cpp
+/// @brief Implementación del generador de carga concurrente y de la verificación de invariantes.
+
+#include "LoadGenerator.h"
+#include "InventoryManager.h"
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QSqlDatabase>
+#include <QStringList>
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <thread>
+
+namespace {
+/// Palabras clave usadas por las búsquedas.
+const char *const kKeywords[] = { "res", "cap", "10k", "LG", "A1", "sensor" };
+/// Tipos asignados a los componentes creados.
+const char *const kTypes[] = { "Resistor", "Capacitor", "Sensor", "Conector" };
+/// Ubicaciones asignadas a los componentes creados.
+const char *const kLocations[] = { "A1", "A2", "B1", "C3" };
+
+/// @brief Devuelve el percentil indicado de un vector ordenado de latencias.
+qint64 percentile(const std::vector<qint64> &sorted, double p)
+{
+    if (sorted.empty())
+        return 0;
+    std::size_t index = std::size_t(p * sorted.size());
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+}
+
+/// @brief Construye las opciones por defecto.
+LoadGeneratorOptions::LoadGeneratorOptions()
+    : dbPath("inventory.db")
+    , threads(4)
+    , operationsPerThread(1000)
+    , counterRows(8)
+    , seed(1)
+    , cleanup(true)
+    , weights({ 40, 15, 20, 10, 10, 5 })
+{}
+
+/// @brief Constructor de LoadGenerator.
+/// @param options Parámetros de la ejecución.
+LoadGenerator::LoadGenerator(const LoadGeneratorOptions &options)
+    : m_options(options)
+{
+    m_options.weights.resize(OperationCount, 0);
+}
+
+/// @brief Interpreta una mezcla "operación=peso,...".
+/// @param mix Texto de la mezcla; las operaciones omitidas tienen peso 0.
+/// @param weights Vector que recibe los pesos, indexado por Operation.
+/// @return true si la mezcla es válida y algún peso es positivo.
+bool LoadGenerator::parseMix(const QString &mix, std::vector<int> &weights)
+{
+    std::vector<int> parsed(OperationCount, 0);
+    int total = 0;
+    for (const QString &pair : mix.split(',')) {
+        if (pair.trimmed().isEmpty())
+            continue;
+        const QStringList parts = pair.split('=');
+        if (parts.size() != 2)
+            return false;
+        bool ok = false;
+        const int weight = parts.at(1).trimmed().toInt(&ok);
+        if (!ok || weight < 0)
+            return false;
+        int op = 0;
+        while (op < OperationCount && operationName(Operation(op)) != parts.at(0).trimmed())
+            ++op;
+        if (op == OperationCount)
+            return false;
+        parsed[op] = weight;
+        total += weight;
+    }
+    if (total == 0)
+        return false;
+    weights = parsed;
+    return true;
+}
+
+/// @brief Nombre de una operación.
+/// @param operation Operación.
+/// @return Nombre en minúsculas usado en la mezcla y el informe.
+QString LoadGenerator::operationName(Operation operation)
+{
+    switch (operation) {
+    case Search:   return "search";
+    case Add:      return "add";
+    case Update:   return "update";
+    case Remove:   return "remove";
+    case Adjust:   return "adjust";
+    case LowStock: return "lowstock";
+    default:       return QString();
+    }
+}
+
+/// @brief Prepara las filas contador, lanza los hilos, informa y verifica los invariantes.
+/// @param out Flujo del informe.
+/// @return true si todos los invariantes se cumplen.
+bool LoadGenerator::run(QTextStream &out)
+{
+    m_runTag = "LG" + QString::number(QDateTime::currentMSecsSinceEpoch(), 36).toUpper();
+    const QString setupConnection = "loadgen_setup_" + m_runTag;
+    bool passed = true;
+    {
+        InventoryManager inventory;
+        if (!inventory.initialize(m_options.dbPath, setupConnection)) {
+            out << "No se pudo abrir " << m_options.dbPath << "\n";
+            return false;
+        }
+
+        std::vector<int> counterIds;
+        for (int i = 0; i < m_options.counterRows; ++i) {
+            int id = -1;
+            Component counter(-1, QString("%1-COUNTER-%2").arg(m_runTag).arg(i), "Contador", 0, "LG");
+            if (!inventory.addComponent(counter, &id)) {
+                out << "No se pudieron crear las filas contador\n";
+                return false;
+            }
+            counterIds.push_back(id);
+        }
+
+        std::vector<WorkerResult> results(m_options.threads);
+        std::vector<std::thread> workers;
+        QElapsedTimer wall;
+        wall.start();
+        for (int i = 0; i < m_options.threads; ++i)
+            workers.emplace_back(&LoadGenerator::runWorker, this, i, std::cref(counterIds), std::ref(results[i]));
+        for (auto &worker : workers)
+            worker.join();
+        const double seconds = qMax<qint64>(wall.elapsed(), 1) / 1000.0;
+
+        // Informe de rendimiento por operación
+        out << "Ejecucion " << m_runTag << ": " << m_options.threads << " hilos x "
+            << m_options.operationsPerThread << " operaciones en " << seconds << " s\n";
+        out << QString("%1%2%3%4%5%6\n").arg("operacion", -10).arg("total", -10).arg("errores", -10)
+                   .arg("ops/s", -10).arg("p50(us)", -10).arg("p99(us)", -10);
+        qint64 totalOps = 0;
+        for (int op = 0; op < OperationCount; ++op) {
+            std::vector<qint64> merged;
+            int errors = 0;
+            for (const WorkerResult &result : results) {
+                if (!result.initialized)
+                    continue;
+                merged.insert(merged.end(), result.latencies[op].begin(), result.latencies[op].end());
+                errors += result.errors[op];
+            }
+            if (merged.empty())
+                continue;
+            std::sort(merged.begin(), merged.end());
+            totalOps += qint64(merged.size());
+            out << QString("%1%2%3%4%5%6\n").arg(operationName(Operation(op)), -10)
+                       .arg(qint64(merged.size()), -10).arg(errors, -10)
+                       .arg(qint64(merged.size() / seconds), -10)
+                       .arg(percentile(merged, 0.50) / 1000, -10)
+                       .arg(percentile(merged, 0.99) / 1000, -10);
+        }
+        out << "Total: " << qint64(totalOps / seconds) << " ops/s\n";
+
+        // Invariantes: filas vivas, cantidades de las filas propias y contadores compartidos
+        int expectedRows = m_options.counterRows;
+        int expectedAdjusts = 0;
+        int lostUpdates = 0;
+        for (const WorkerResult &result : results) {
+            if (!result.initialized) {
+                out << "FALLO: un hilo no pudo abrir la base de datos\n";
+                passed = false;
+                continue;
+            }
+            expectedRows += result.adds - result.removes;
+            expectedAdjusts += result.adjusts;
+            for (const auto &expected : result.expectedQuantities) {
+                Component c;
+                if (!inventory.getComponent(expected.first, c) || c.quantity() != expected.second)
+                    ++lostUpdates;
+            }
+        }
+
+        const std::vector<ComponentSummary> rows = inventory.searchComponents(m_runTag + "-");
+        if (int(rows.size()) != expectedRows) {
+            out << "FALLO: filas esperadas " << expectedRows << ", encontradas " << int(rows.size()) << "\n";
+            passed = false;
+        }
+        if (lostUpdates > 0) {
+            out << "FALLO: " << lostUpdates << " filas con cantidad distinta a la ultima escrita\n";
+            passed = false;
+        }
+        int counterSum = 0;
+        for (int id : counterIds) {
+            Component c;
+            if (inventory.getComponent(id, c))
+                counterSum += c.quantity();
+        }
+        if (counterSum != expectedAdjusts) {
+            out << "FALLO: suma de contadores " << counterSum << ", esperada " << expectedAdjusts << "\n";
+            passed = false;
+        }
+        if (passed)
+            out << "Invariantes: OK (" << expectedRows << " filas, " << expectedAdjusts << " ajustes)\n";
+
+        if (m_options.cleanup) {
+            for (const ComponentSummary &c : rows)
+                inventory.removeComponent(c.id);
+        }
+    }
+    QSqlDatabase::removeDatabase(setupConnection);
+    return passed;
+}
+
+/// @brief Ejecuta las operaciones de un hilo con su propia conexión y registra latencias.
+/// @param index Índice del hilo (usado en la semilla y en los nombres creados).
+/// @param counterIds IDs de las filas contador compartidas.
+/// @param result Resultado del hilo.
+void LoadGenerator::runWorker(int index, const std::vector<int> &counterIds, WorkerResult &result)
+{
+    result.latencies.assign(OperationCount, std::vector<qint64>());
+    result.errors.assign(OperationCount, 0);
+    result.adds = result.removes = result.adjusts = 0;
+    result.initialized = false;
+
+    const QString connection = QString("loadgen_%1_%2").arg(m_runTag).arg(index);
+    {
+        InventoryManager inventory;
+        if (!inventory.initialize(m_options.dbPath, connection))
+            return;
+        result.initialized = true;
+
+        std::mt19937 rng(m_options.seed + unsigned(index));
+        std::discrete_distribution<int> pick(m_options.weights.begin(), m_options.weights.end());
+        std::vector<int> owned;
+        QElapsedTimer timer;
+
+        for (int i = 0; i < m_options.operationsPerThread; ++i) {
+            Operation op = Operation(pick(rng));
+            if ((op == Update || op == Remove) && owned.empty())
+                op = Add;
+            if (op == Adjust && counterIds.empty())
+                op = Search;
+
+            bool ok = true;
+            timer.start();
+            switch (op) {
+            case Search:
+                inventory.searchComponents(kKeywords[rng() % (sizeof(kKeywords) / sizeof(*kKeywords))]);
+                break;
+            case Add: {
+                const int quantity = int(rng() % 100);
+                Component c(-1, QString("%1-%2-%3").arg(m_runTag).arg(index).arg(i),
+                            kTypes[rng() % (sizeof(kTypes) / sizeof(*kTypes))], quantity,
+                            kLocations[rng() % (sizeof(kLocations) / sizeof(*kLocations))]);
+                int id = -1;
+                ok = inventory.addComponent(c, &id);
+                if (ok) {
+                    owned.push_back(id);
+                    result.expectedQuantities[id] = quantity;
+                    ++result.adds;
+                }
+                break;
+            }
+            case Update: {
+                const int id = owned[rng() % owned.size()];
+                Component c;
+                ok = inventory.getComponent(id, c);
+                if (ok) {
+                    c.setQuantity(int(rng() % 100));
+                    c.setLocation(kLocations[rng() % (sizeof(kLocations) / sizeof(*kLocations))]);
+                    ok = inventory.updateComponent(c);
+                    if (ok)
+                        result.expectedQuantities[id] = c.quantity();
+                }
+                break;
+            }
+            case Remove: {
+                const std::size_t k = rng() % owned.size();
+                const int id = owned[k];
+                ok = inventory.removeComponent(id);
+                if (ok) {
+                    owned[k] = owned.back();
+                    owned.pop_back();
+                    result.expectedQuantities.erase(id);
+                    ++result.removes;
+                }
+                break;
+            }
+            case Adjust:
+                ok = inventory.adjustQuantity(counterIds[rng() % counterIds.size()], 1);
+                if (ok)
+                    ++result.adjusts;
+                break;
+            case LowStock:
+                inventory.getLowStockComponents(5);
+                break;
+            default:
+                break;
+            }
+            result.latencies[op].push_back(timer.nsecsElapsed());
+            if (!ok)
+                ++result.errors[op];
+        }
+    }
+    QSqlDatabase::removeDatabase(connection);
+}
@@ -0,0 +1,83 @@
+/// @file LoadGenerator.h
+/// @brief Declaración de la clase LoadGenerator, generador de carga concurrente sobre InventoryManager.
+
+#ifndef LOADGENERATOR_H
+#define LOADGENERATOR_H
+
+#include <QString>
+#include <QTextStream>
+#include <map>
+#include <vector>
+
+/// @struct LoadGeneratorOptions
+/// @brief Parámetros de una ejecución del generador de carga.
+struct LoadGeneratorOptions {
+    QString dbPath;             ///< Base de datos compartida por todos los hilos.
+    int threads;                ///< Número de hilos trabajadores.
+    int operationsPerThread;    ///< Operaciones que ejecuta cada hilo.
+    int counterRows;            ///< Filas contador compartidas para los ajustes concurrentes.
+    unsigned int seed;          ///< Semilla base del generador aleatorio (cada hilo suma su índice).
+    bool cleanup;               ///< Eliminar al final las filas creadas por la ejecución.
+    std::vector<int> weights;   ///< Peso relativo de cada LoadGenerator::Operation.
+
+    /// @brief Construye las opciones por defecto (4 hilos, 1000 operaciones, mezcla de lectura dominante).
+    LoadGeneratorOptions();
+};
+
+/// @class LoadGenerator
+/// @brief Ejecuta una mezcla configurable de operaciones desde varios hilos y verifica invariantes.
+///
+/// Cada hilo usa su propio InventoryManager con una conexión independiente a la misma base.
+/// Las filas que crea un hilo solo las modifica ese hilo, de modo que su cantidad final es
+/// conocida; además, todos los hilos ajustan en paralelo unas filas contador compartidas.
+/// Al terminar se comprueba que el número de filas, la cantidad de cada fila propia y la
+/// suma de los contadores coinciden con lo esperado (sin actualizaciones perdidas), y se
+/// informa del rendimiento y de las latencias p50/p99 por operación.
+class LoadGenerator {
+public:
+    /// @brief Tipos de operación que genera la carga.
+    enum Operation { Search, Add, Update, Remove, Adjust, LowStock, OperationCount };
+
+    /// @brief Constructor de LoadGenerator.
+    /// @param options Parámetros de la ejecución.
+    explicit LoadGenerator(const LoadGeneratorOptions &options);
+
+    /// @brief Interpreta una mezcla de operaciones con formato "search=40,add=15,...".
+    /// @param mix Texto con pares operación=peso separados por comas.
+    /// @param weights Vector que recibe el peso de cada operación.
+    /// @return true si todas las operaciones y pesos son válidos; false en caso contrario.
+    static bool parseMix(const QString &mix, std::vector<int> &weights);
+
+    /// @brief Nombre de una operación tal como se usa en la mezcla y el informe.
+    /// @param operation Operación.
+    /// @return Nombre en minúsculas.
+    static QString operationName(Operation operation);
+
+    /// @brief Ejecuta la carga, escribe el informe y verifica los invariantes.
+    /// @param out Flujo donde se escribe el informe.
+    /// @return true si la carga se ejecuta y todos los invariantes se cumplen.
+    bool run(QTextStream &out);
+
+private:
+    /// @brief Resultado acumulado por un hilo trabajador.
+    struct WorkerResult {
+        std::vector<std::vector<qint64>> latencies; ///< Latencias (ns) por operación.
+        std::vector<int> errors;                    ///< Operaciones fallidas por tipo.
+        std::map<int, int> expectedQuantities;      ///< Filas propias vivas → cantidad esperada.
+        int adds;                                   ///< Altas correctas.
+        int removes;                                ///< Bajas correctas.
+        int adjusts;                                ///< Ajustes correctos sobre los contadores.
+        bool initialized;                           ///< false si el hilo no pudo abrir la base.
+    };
+
+    /// @brief Cuerpo de un hilo trabajador.
+    /// @param index Índice del hilo.
+    /// @param counterIds IDs de las filas contador compartidas.
+    /// @param result Resultado que rellena el hilo.
+    void runWorker(int index, const std::vector<int> &counterIds, WorkerResult &result);
+
+    LoadGeneratorOptions m_options;  ///< Parámetros de la ejecución.
+    QString m_runTag;                ///< Prefijo único de los nombres creados en esta ejecución.
+};
+
+#endif // LOADGENERATOR_H
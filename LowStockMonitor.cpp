@@ -0,0 +1,85 @@
+/// @file LowStockMonitor.cpp
+/// @brief Implementación de la clase LowStockMonitor para la evaluación incremental de umbrales.
+
+#include "LowStockMonitor.h"
+
+/// @brief Constructor de LowStockMonitor.
+/// @param parent Objeto padre en la jerarquía de Qt (por defecto nullptr).
+LowStockMonitor::LowStockMonitor(QObject *parent)
+    : QObject(parent)
+    , m_defaultThreshold(0)
+{}
+
+/// @brief Establece el umbral general.
+/// @param threshold Nuevo umbral general (los negativos se tratan como 0).
+void LowStockMonitor::setDefaultThreshold(int threshold)
+{
+    m_defaultThreshold = threshold < 0 ? 0 : threshold;
+}
+
+/// @brief Obtiene el umbral general.
+/// @return Umbral general actual.
+int LowStockMonitor::defaultThreshold() const
+{
+    return m_defaultThreshold;
+}
+
+/// @brief Umbral de un tipo de componente.
+/// @param type Tipo de componente.
+/// @return Umbral del tipo, o -1 si no tiene.
+int LowStockMonitor::typeThreshold(const QString &type) const
+{
+    return m_typeThresholds.value(type, -1);
+}
+
+/// @brief Establece o elimina el umbral de un tipo de componente.
+/// @param type Tipo de componente.
+/// @param threshold Umbral del tipo; si es negativo se elimina.
+void LowStockMonitor::setTypeThreshold(const QString &type, int threshold)
+{
+    if (threshold < 0)
+        m_typeThresholds.remove(type);
+    else
+        m_typeThresholds.insert(type, threshold);
+}
+
+/// @brief Reemplaza la tabla completa de umbrales por tipo.
+/// @param thresholds Tabla tipo → umbral.
+void LowStockMonitor::setTypeThresholds(const QHash<QString, int> &thresholds)
+{
+    m_typeThresholds = thresholds;
+}
+
+/// @brief Resuelve el umbral efectivo de un componente.
+/// @param component Componente a evaluar.
+/// @return Umbral propio, del tipo o general.
+int LowStockMonitor::effectiveThreshold(const Component &component) const
+{
+    if (component.hasReorderThreshold())
+        return component.reorderThreshold();
+    return m_typeThresholds.value(component.type(), m_defaultThreshold);
+}
+
+/// @brief Indica si el componente está en o por debajo de su umbral efectivo.
+/// @param component Componente a evaluar.
+/// @return true si la cantidad es menor o igual al umbral.
+bool LowStockMonitor::isLow(const Component &component) const
+{
+    return component.quantity() <= effectiveThreshold(component);
+}
+
+/// @brief Compara las imágenes anterior y posterior de una fila y emite alertas de cruce.
+/// @param before Imagen previa (nullptr si la fila es nueva).
+/// @param after Imagen posterior (nullptr si la fila se ha eliminado).
+void LowStockMonitor::evaluate(const Component *before, const Component *after)
+{
+    if (!after)
+        return;
+
+    const bool wasLow = before && isLow(*before);
+    const bool nowLow = isLow(*after);
+    if (!wasLow && nowLow)
+        emit thresholdCrossed(*after, effectiveThreshold(*after));
+    else if (wasLow && !nowLow)
+        emit stockRecovered(*after, effectiveThreshold(*after));
+}
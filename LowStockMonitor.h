@@ -0,0 +1,80 @@
+/// @file LowStockMonitor.h
+/// @brief Declaración de la clase LowStockMonitor, motor de alertas de bajo stock por umbral.
+
+#ifndef LOWSTOCKMONITOR_H
+#define LOWSTOCKMONITOR_H
+
+#include <QObject>
+#include <QHash>
+#include <QString>
+#include "Component.h"
+
+/// @class LowStockMonitor
+/// @brief Evalúa los umbrales de reposición de los componentes modificados y emite alertas.
+///
+/// El umbral efectivo de un componente se resuelve en este orden: el umbral propio del
+/// componente, el umbral de su tipo y, por último, el umbral general. El monitor no
+/// recorre la tabla: cada escritura le entrega la imagen anterior y posterior de la fila
+/// afectada, de modo que el coste de evaluación es proporcional a las filas modificadas.
+class LowStockMonitor : public QObject {
+    Q_OBJECT
+
+public:
+    /// @brief Constructor de LowStockMonitor.
+    /// @param parent Objeto padre en la jerarquía de Qt (por defecto nullptr).
+    explicit LowStockMonitor(QObject *parent = nullptr);
+
+    /// @brief Establece el umbral general usado cuando ni el componente ni su tipo definen uno.
+    /// @param threshold Cantidad máxima para considerar un componente con bajo stock.
+    void setDefaultThreshold(int threshold);
+
+    /// @brief Obtiene el umbral general.
+    /// @return El umbral general actual.
+    int defaultThreshold() const;
+
+    /// @brief Establece (o elimina) el umbral de reposición de un tipo de componente.
+    /// @param type Tipo o categoría de componente.
+    /// @param threshold Umbral del tipo; un valor negativo elimina el umbral del tipo.
+    void setTypeThreshold(const QString &type, int threshold);
+
+    /// @brief Obtiene el umbral de reposición de un tipo de componente.
+    /// @param type Tipo o categoría de componente.
+    /// @return Umbral del tipo, o -1 si el tipo no define uno.
+    int typeThreshold(const QString &type) const;
+
+    /// @brief Reemplaza todos los umbrales por tipo.
+    /// @param thresholds Tabla tipo → umbral.
+    void setTypeThresholds(const QHash<QString, int> &thresholds);
+
+    /// @brief Calcula el umbral efectivo de un componente.
+    /// @param component Componente a evaluar.
+    /// @return Umbral propio, del tipo o general, en ese orden de prioridad.
+    int effectiveThreshold(const Component &component) const;
+
+    /// @brief Indica si un componente está en o por debajo de su umbral efectivo.
+    /// @param component Componente a evaluar.
+    /// @return true si la cantidad es menor o igual al umbral efectivo.
+    bool isLow(const Component &component) const;
+
+    /// @brief Evalúa una escritura y emite las señales correspondientes si cruza el umbral.
+    /// @param before Imagen previa de la fila (nullptr en inserciones).
+    /// @param after Imagen posterior de la fila (nullptr en eliminaciones).
+    void evaluate(const Component *before, const Component *after);
+
+signals:
+    /// @brief Se emite cuando un componente pasa a estar en o por debajo de su umbral.
+    /// @param component Estado actual del componente.
+    /// @param threshold Umbral efectivo que se ha cruzado.
+    void thresholdCrossed(const Component &component, int threshold);
+
+    /// @brief Se emite cuando un componente con bajo stock vuelve a superar su umbral.
+    /// @param component Estado actual del componente.
+    /// @param threshold Umbral efectivo del componente.
+    void stockRecovered(const Component &component, int threshold);
+
+private:
+    int m_defaultThreshold;                  ///< Umbral general.
+    QHash<QString, int> m_typeThresholds;    ///< Umbrales por tipo de componente.
+};
+
+#endif // LOWSTOCKMONITOR_H
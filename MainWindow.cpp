@@ -2,9 +2,30 @@
 /// @brief Implementación de la clase MainWindow para la interfaz principal de la aplicación.
 #include "MainWindow.h"
 #include "ui_MainWindow.h"
+#include "ComponentSchema.h"
 #include <QMessageBox>
 #include <QInputDialog>
 #include <QFileDialog>
+#include <QStatusBar>
+#include <QApplication>
+#include <limits>
+
+namespace {
+/// Número máximo de filas de la tabla, haya o no presupuesto de memoria.
+const int kMaxTableRows = 10000;
+/// Filas que se muestran aunque el presupuesto esté agotado.
+const int kMinTableRows = 100;
+/// Coste aproximado de un QStandardItem sin su texto.
+const qint64 kItemBytes = 96;
+/// Estimación de una fila completa (un elemento por columna y sus cadenas) para calcular el límite.
+const qint64 kRowBytesEstimate = ComponentSchema::ListFields::size * kItemBytes + 160;
+/// Columna del ID en la tabla.
+const int kIdColumn = ComponentSchema::ListFields::indexOf<ComponentSchema::Id>();
+/// Columna de la cantidad en la tabla.
+const int kQuantityColumn = ComponentSchema::ListFields::indexOf<ComponentSchema::Quantity>();
+/// Columna del tipo en la tabla.
+const int kTypeColumn = ComponentSchema::ListFields::indexOf<ComponentSchema::Type>();
+}
 
 /// @brief Constructor de MainWindow.
 ///        Inicializa la interfaz, abre la base de datos, configura el modelo y carga la tabla.
@@ -13,6 +34,8 @@ MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
     , m_model(new QStandardItemModel(this))
+    , m_modelAccount("Tabla de componentes", MemoryBudget::Buffer)
+    , m_scanPipeline(&m_inventory)
 {
     ui->setupUi(this);
     // Inicializar base de datos
@@ -21,8 +44,46 @@ MainWindow::MainWindow(QWidget *parent)
         QMessageBox::critical(this, "Error", "No se pudo abrir la base de datos.");
         exit(EXIT_FAILURE);
     }
+    m_inventory.setDefaultLowStockThreshold(ui->lowStockSpinBox->value());
+    connect(ui->lowStockSpinBox, QOverload<int>::of(&QSpinBox::valueChanged),
+            &m_inventory, &InventoryManager::setDefaultLowStockThreshold);
+    connect(&m_inventory, &InventoryManager::lowStockAlert,
+            this, &MainWindow::showLowStockAlert);
+    // Las ediciones en ráfaga comparten transacción: se confirman cada 250 ms o cada 64 escrituras
+    m_inventory.setWriteCoalescing(250, 64);
+    connect(&m_inventory, &InventoryManager::undoRedoChanged,
+            this, &MainWindow::updateUndoRedoButtons);
+    connect(&m_inventory, &InventoryManager::pendingWritesDiscarded, this, [this](int shardId) {
+        QMessageBox::warning(this, "Error",
+                             QString("No se pudieron guardar los ultimos cambios (fragmento %1).").arg(shardId));
+        loadTable();
+    });
+    ui->undoButton->setShortcut(QKeySequence::Undo);
+    ui->redoButton->setShortcut(QKeySequence::Redo);
+    updateUndoRedoButtons(false, false);
     setupModel();
     loadTable();
+
+    // Los rellenos e índices de las migraciones se aplican sin bloquear el arranque
+    connect(&m_inventory, &InventoryManager::migrationProgress,
+            this, &MainWindow::showMigrationProgress);
+    connect(&m_inventory, &InventoryManager::migrationsFinished, this, [this](bool ok) {
+        statusBar()->showMessage(ok ? "Esquema actualizado." : "Error al migrar el esquema.", 5000);
+    });
+    m_inventory.startBackgroundMigrations();
+
+    // Recuento con lector: las lecturas se acumulan y se confirman por lotes
+    connect(&m_scanPipeline, &ScanPipeline::scanned, this, &MainWindow::showScan);
+    connect(&m_scanPipeline, &ScanPipeline::unknownCode, this, [this](const QString &code) {
+        QApplication::beep();
+        statusBar()->showMessage("Codigo desconocido: " + code, 5000);
+    });
+    connect(&m_scanPipeline, &ScanPipeline::flushed, this, [this](bool ok, int components, int scans) {
+        statusBar()->showMessage(ok ? QString("Recuento: %1 lecturas confirmadas en %2 componentes.")
+                                          .arg(scans).arg(components)
+                                    : QString("Error al confirmar el recuento; se reintentara."),
+                                 5000);
+    });
 }
 
 /// @brief Destructor de MainWindow.
@@ -36,8 +97,7 @@ MainWindow::~MainWindow()
 ///        Define los encabezados y las propiedades de selección y edición.
 void MainWindow::setupModel()
 {
-    QStringList headers = {"ID", "Nombre", "Tipo", "Cantidad", "Ubicacion", "Fecha Compra"};
-    m_model->setHorizontalHeaderLabels(headers);
+    m_model->setHorizontalHeaderLabels(ComponentSchema::ListFields::labels());
     ui->componentsTableView->setModel(m_model);
     ui->componentsTableView->setSelectionBehavior(QAbstractItemView::SelectRows);
     ui->componentsTableView->setEditTriggers(QAbstractItemView::NoEditTriggers);
@@ -47,25 +107,49 @@ void MainWindow::setupModel()
 void MainWindow::loadTable()
 {
     m_model->removeRows(0, m_model->rowCount());
-    auto components = m_inventory.getAllComponents();
-    refreshTable(components);
+    m_modelAccount.setUsage(0);
+    bool truncated = false;
+    auto components = m_inventory.getAllComponents(rowLimit(), &truncated);
+    refreshTable(components, truncated);
+}
+
+/// @brief Filas que caben en la memoria disponible; el modelo actual cuenta como disponible
+///        porque se reemplaza.
+/// @return Límite de filas entre kMinTableRows y kMaxTableRows.
+int MainWindow::rowLimit() const
+{
+    const qint64 available = MemoryBudget::global().available();
+    const qint64 budget = available > std::numeric_limits<qint64>::max() - m_modelAccount.usage()
+                              ? available
+                              : available + m_modelAccount.usage();
+    return int(qBound<qint64>(kMinTableRows, budget / kRowBytesEstimate, kMaxTableRows));
 }
 
 /// @brief Rellena la tabla con la lista de componentes proporcionada.
-/// @param components Vector de objetos Component a mostrar.
-void MainWindow::refreshTable(const std::vector<Component> &components)
+/// @param components Resúmenes de los componentes a mostrar.
+/// @param truncated true si hay más resultados que los mostrados.
+void MainWindow::refreshTable(const std::vector<ComponentSummary> &components, bool truncated)
 {
     m_model->removeRows(0, m_model->rowCount());
+    m_rowById.clear();
+    qint64 modelBytes = 0;
     for (const auto &c : components) {
         QList<QStandardItem*> row;
-        row << new QStandardItem(QString::number(c.id()));
-        row << new QStandardItem(c.name());
-        row << new QStandardItem(c.type());
-        row << new QStandardItem(QString::number(c.quantity()));
-        row << new QStandardItem(c.location());
-        row << new QStandardItem(c.purchaseDate().toString(Qt::ISODate));
+        auto appendCell = [&](int column, const QString &text) {
+            // Se suman las lecturas aún no confirmadas para que el recuento no retroceda
+            row << new QStandardItem(column == kQuantityColumn
+                                         ? QString::number(c.quantity + m_scanPipeline.pendingDelta(c.id))
+                                         : text);
+        };
+        ComponentSchema::ListFields::forEachText(c, appendCell);
+        m_rowById.insert(c.id, m_model->rowCount());
         m_model->appendRow(row);
+        modelBytes += ComponentSchema::ListFields::size * kItemBytes + MemoryBudget::estimate(c);
     }
+    m_modelAccount.setUsage(modelBytes);
+    if (truncated)
+        statusBar()->showMessage(QString("Se muestran los primeros %1 componentes; refine la busqueda para ver el resto.")
+                                     .arg(components.size()));
 }
 
 /// @brief Slot que actualiza la tabla según el texto ingresado en el campo de búsqueda.
@@ -75,11 +159,28 @@ void MainWindow::on_searchLineEdit_textChanged(const QString &text)
     if (text.isEmpty()) {
         loadTable();
     } else {
-        auto results = m_inventory.searchComponents(text);
-        refreshTable(results);
+        bool truncated = false;
+        auto results = m_inventory.searchComponents(text, rowLimit(), &truncated);
+        // Sin coincidencias exactas: se muestran las más parecidas (errores de escritura)
+        if (results.empty()) {
+            results = m_inventory.fuzzySearch(text);
+            if (!results.empty())
+                statusBar()->showMessage("Resultados aproximados para: " + text, 3000);
+        }
+        refreshTable(results, truncated);
     }
 }
 
+/// @brief Slot que registra la lectura del campo de escaneo y lo deja listo para la siguiente.
+///        No hay diálogos ni recargas: la lectura se acumula y la tabla se actualiza en su sitio.
+void MainWindow::on_scanLineEdit_returnPressed()
+{
+    const QString code = ui->scanLineEdit->text();
+    ui->scanLineEdit->clear();
+    if (!code.trimmed().isEmpty())
+        m_scanPipeline.scan(code);
+}
+
 /// @brief Slot que solicita datos al usuario y agrega un nuevo componente al inventario.
 void MainWindow::on_addButton_clicked()
 {
@@ -99,8 +200,12 @@ void MainWindow::on_addButton_clicked()
     QDate date = dateText.isEmpty()
                   ? QDate::currentDate()
                   : QDate::fromString(dateText, Qt::ISODate);
+    // -1 indica que se usa el umbral del tipo o el general
+    int threshold = QInputDialog::getInt(this, "Umbral", "Umbral de reposicion (-1 = general):",
+                                         -1, -1, 10000, 1, &ok);
+    if (!ok) return;
 
-    Component c(-1, name, type, quantity, location, date);
+    Component c(-1, name, type, quantity, location, date, threshold);
     if (m_inventory.addComponent(c)) {
         loadTable();
     } else {
@@ -109,25 +214,50 @@ void MainWindow::on_addButton_clicked()
 }
 
 /// @brief Slot que edita el componente seleccionado solicitando nuevos valores al usuario.
+///        La tabla solo tiene el resumen: los valores actuales, incluidos los campos de
+///        detalle, se leen de la base de datos por su ID.
 void MainWindow::on_editButton_clicked()
 {
     auto index = ui->componentsTableView->currentIndex();
     if (!index.isValid()) return;
 
-    int row = index.row();
-    int id = m_model->item(row, 0)->text().toInt();
+    int id = m_model->item(index.row(), kIdColumn)->text().toInt();
+    // Las lecturas pendientes se confirman antes para que la cantidad editada las incluya
+    m_scanPipeline.flush();
+    Component c;
+    if (!m_inventory.getComponent(id, c)) {
+        QMessageBox::warning(this, "Error", "El componente ya no existe.");
+        loadTable();
+        return;
+    }
 
-    QString name = QInputDialog::getText(this, "Nombre", "Nuevo nombre:",
-                                         QLineEdit::Normal, m_model->item(row, 1)->text(), nullptr);
-    QString type = QInputDialog::getText(this, "Tipo", "Nuevo tipo:",
-                                         QLineEdit::Normal, m_model->item(row, 2)->text(), nullptr);
-    int quantity = QInputDialog::getInt(this, "Cantidad", "Nueva cantidad:",
-                                        m_model->item(row, 3)->text().toInt(), 0, 10000, 1, nullptr);
-    QString location = QInputDialog::getText(this, "Ubicacion", "Nueva ubicacion:",
-                                             QLineEdit::Normal, m_model->item(row, 4)->text(), nullptr);
-    QDate date = QDate::fromString(m_model->item(row, 5)->text(), Qt::ISODate);
+    // Cancelar cualquier paso abandona la edición sin escribir nada
+    bool ok;
+    c.setName(QInputDialog::getText(this, "Nombre", "Nuevo nombre:",
+                                    QLineEdit::Normal, c.name(), &ok));
+    if (!ok) return;
+    c.setType(QInputDialog::getText(this, "Tipo", "Nuevo tipo:",
+                                    QLineEdit::Normal, c.type(), &ok));
+    if (!ok) return;
+    c.setQuantity(QInputDialog::getInt(this, "Cantidad", "Nueva cantidad:",
+                                       c.quantity(), 0, 10000, 1, &ok));
+    if (!ok) return;
+    c.setLocation(QInputDialog::getText(this, "Ubicacion", "Nueva ubicacion:",
+                                        QLineEdit::Normal, c.location(), &ok));
+    if (!ok) return;
+    c.setReorderThreshold(QInputDialog::getInt(this, "Umbral", "Nuevo umbral de reposicion (-1 = general):",
+                                               c.reorderThreshold(), -1, 10000, 1, &ok));
+    if (!ok) return;
+    c.setNotes(QInputDialog::getMultiLineText(this, "Notas", "Notas:", c.notes(), &ok));
+    if (!ok) return;
+    c.setDatasheetUrl(QInputDialog::getText(this, "Hoja de datos", "URL de la hoja de datos:",
+                                            QLineEdit::Normal, c.datasheetUrl(), &ok));
+    if (!ok) return;
+    c.setBarcode(QInputDialog::getText(this, "Codigo de barras", "Codigo de barras:",
+                                       QLineEdit::Normal, c.barcode(), &ok).trimmed());
+    if (!ok) return;
 
-    Component c(id, name, type, quantity, location, date);
+    m_scanPipeline.clearCache();
     if (m_inventory.updateComponent(c)) {
         loadTable();
     } else {
@@ -141,9 +271,11 @@ void MainWindow::on_deleteButton_clicked()
     auto index = ui->componentsTableView->currentIndex();
     if (!index.isValid()) return;
 
-    int id = m_model->item(index.row(), 0)->text().toInt();
+    int id = m_model->item(index.row(), kIdColumn)->text().toInt();
     if (QMessageBox::question(this, "Eliminar", "¿Eliminar este componente?",
                               QMessageBox::Yes | QMessageBox::No) == QMessageBox::Yes) {
+        m_scanPipeline.flush();
+        m_scanPipeline.clearCache();
         if (m_inventory.removeComponent(id)) {
             loadTable();
         } else {
@@ -152,22 +284,78 @@ void MainWindow::on_deleteButton_clicked()
     }
 }
 
+/// @brief Slot que deshace la última operación de escritura y recarga la tabla.
+void MainWindow::on_undoButton_clicked()
+{
+    m_scanPipeline.flush();
+    if (m_inventory.undo()) {
+        loadTable();
+    } else {
+        QMessageBox::warning(this, "Error", "No se pudo deshacer la operacion.");
+    }
+}
+
+/// @brief Slot que rehace la última operación deshecha y recarga la tabla.
+void MainWindow::on_redoButton_clicked()
+{
+    m_scanPipeline.flush();
+    if (m_inventory.redo()) {
+        loadTable();
+    } else {
+        QMessageBox::warning(this, "Error", "No se pudo rehacer la operacion.");
+    }
+}
+
 /// @brief Slot que filtra y muestra los componentes con stock por debajo del umbral indicado.
 void MainWindow::on_checkLowStockButton_clicked()
 {
     int threshold = ui->lowStockSpinBox->value();
-    auto low = m_inventory.getLowStockComponents(threshold);
-    refreshTable(low);
+    bool truncated = false;
+    auto low = m_inventory.getLowStockComponents(threshold, rowLimit(), &truncated);
+    refreshTable(low, truncated);
+}
+
+/// @brief Slot que establece el umbral de reposición de un tipo de componente.
+///        Se aplica a todos los componentes del tipo sin umbral propio; el tipo propuesto
+///        es el del componente seleccionado.
+void MainWindow::on_typeThresholdButton_clicked()
+{
+    QString type;
+    auto index = ui->componentsTableView->currentIndex();
+    if (index.isValid())
+        type = m_model->item(index.row(), kTypeColumn)->text();
+
+    bool ok;
+    type = QInputDialog::getText(this, "Umbral por tipo", "Tipo:", QLineEdit::Normal, type, &ok).trimmed();
+    if (!ok || type.isEmpty()) return;
+    const int current = m_inventory.typeThreshold(type);
+    const int threshold = QInputDialog::getInt(this, "Umbral por tipo",
+                                               QString("Umbral de reposicion del tipo %1 (-1 = general):").arg(type),
+                                               current, -1, 10000, 1, &ok);
+    if (!ok || threshold == current) return;
+
+    if (m_inventory.setTypeThreshold(type, threshold)) {
+        statusBar()->showMessage(threshold < 0
+                                     ? QString("El tipo %1 usa el umbral general.").arg(type)
+                                     : QString("Umbral del tipo %1: %2").arg(type).arg(threshold),
+                                 5000);
+    } else {
+        QMessageBox::warning(this, "Error", "No se pudo guardar el umbral del tipo.");
+    }
 }
 
 /// @brief Slot que exporta todos los componentes a un archivo CSV seleccionado por el usuario.
 void MainWindow::on_exportCSVButton_clicked()
 {
-    QString filePath = QFileDialog::getSaveFileName(this, "Guardar CSV", "", "CSV Files (*.csv)");
+    QString filePath = QFileDialog::getSaveFileName(this, "Guardar CSV", "",
+                                                    "CSV Files (*.csv);;CSV comprimido (*.csv.gz)");
     if (filePath.isEmpty()) return;
 
-    auto all = m_inventory.getAllComponents();
-    if (!m_reporter.generateCSV(filePath, all)) {
+    // Lectura en flujo: con .gz el archivo se comprime mientras se escribe
+    auto source = [this](const std::function<bool(const Component &)> &visitor) {
+        return m_inventory.forEachComponent(visitor);
+    };
+    if (!m_reporter.generateCSV(filePath, source)) {
         QMessageBox::warning(this, "Error", "No se pudo generar el CSV.");
     }
 }
@@ -178,9 +366,93 @@ void MainWindow::on_exportPDFButton_clicked()
     QString filePath = QFileDialog::getSaveFileName(this, "Guardar PDF", "", "PDF Files (*.pdf)");
     if (filePath.isEmpty()) return;
 
-    auto all = m_inventory.getAllComponents();
+    // El PDF se construye entero en memoria: si el inventario no cabe en el presupuesto,
+    // se ofrece exportar solo las primeras filas (el CSV no tiene este límite)
+    bool truncated = false;
+    auto all = m_inventory.getAllComponents(rowLimit(), &truncated);
+    if (truncated
+        && QMessageBox::question(this, "Exportar PDF",
+                                 QString("El inventario no cabe en la memoria disponible para un PDF.\n"
+                                         "¿Exportar solo los primeros %1 componentes?\n"
+                                         "Para el inventario completo use la exportacion CSV.")
+                                     .arg(all.size()),
+                                 QMessageBox::Yes | QMessageBox::No) != QMessageBox::Yes)
+        return;
     if (!m_reporter.generatePDF(filePath, all)) {
         QMessageBox::warning(this, "Error", "No se pudo generar el PDF.");
     }
 }
 
+/// @brief Slot que exporta todo el inventario al formato columnar GICF, leyendo la base en flujo.
+void MainWindow::on_exportColumnarButton_clicked()
+{
+    QString filePath = QFileDialog::getSaveFileName(this, "Guardar columnar", "",
+                                                    "GICF Files (*.gicf);;GICF comprimido (*.gicf.gz)");
+    if (filePath.isEmpty()) return;
+
+    auto source = [this](const std::function<bool(const Component &)> &visitor) {
+        return m_inventory.forEachComponent(visitor);
+    };
+    if (!m_reporter.generateColumnar(filePath, source)) {
+        QMessageBox::warning(this, "Error", "No se pudo generar el archivo columnar.");
+    }
+}
+
+/// @brief Slot que exporta a CSV el histograma de antigüedad por tipo (franjas de 30, 90, 180 y 365 días).
+void MainWindow::on_exportAgingButton_clicked()
+{
+    QString filePath = QFileDialog::getSaveFileName(this, "Guardar antigüedad", "",
+                                                    "CSV Files (*.csv);;CSV comprimido (*.csv.gz)");
+    if (filePath.isEmpty()) return;
+
+    AgingHistogram histogram;
+    if (!m_inventory.agingHistogram({30, 90, 180, 365}, histogram)
+        || !m_reporter.generateAgingReport(filePath, histogram)) {
+        QMessageBox::warning(this, "Error", "No se pudo generar el informe de antigüedad.");
+    }
+}
+
+/// @brief Slot que informa en la barra de estado de un componente que ha cruzado su umbral.
+/// @param component Componente con bajo stock tras la última escritura.
+/// @param threshold Umbral efectivo del componente.
+void MainWindow::showLowStockAlert(const Component &component, int threshold)
+{
+    statusBar()->showMessage(QString("Bajo stock: %1 (%2 <= %3)")
+                                 .arg(component.name())
+                                 .arg(component.quantity())
+                                 .arg(threshold));
+}
+
+/// @brief Slot que sincroniza el estado de los botones de deshacer y rehacer.
+/// @param canUndo true si hay operaciones que deshacer.
+/// @param canRedo true si hay operaciones que rehacer.
+void MainWindow::updateUndoRedoButtons(bool canUndo, bool canRedo)
+{
+    ui->undoButton->setEnabled(canUndo);
+    ui->redoButton->setEnabled(canRedo);
+}
+
+/// @brief Slot que informa del avance de la migración del esquema en segundo plano.
+/// @param version Versión del esquema en curso.
+/// @param done Trabajo completado.
+/// @param total Trabajo total de la fase.
+void MainWindow::showMigrationProgress(int version, qint64 done, qint64 total)
+{
+    statusBar()->showMessage(QString("Migrando esquema v%1: %2/%3").arg(version).arg(done).arg(total));
+}
+
+/// @brief Slot que refleja una lectura en la tabla sin recargarla.
+/// @param code Código leído.
+/// @param componentId Componente al que corresponde.
+/// @param delta Unidades sumadas por la lectura.
+void MainWindow::showScan(const QString &code, int componentId, int delta)
+{
+    const int row = m_rowById.value(componentId, -1);
+    if (row < 0) {
+        statusBar()->showMessage(QString("Leido %1 (ID %2, fuera de la vista)").arg(code).arg(componentId), 3000);
+        return;
+    }
+    QStandardItem *quantity = m_model->item(row, kQuantityColumn);
+    quantity->setText(QString::number(quantity->text().toInt() + delta));
+    ui->componentsTableView->scrollTo(m_model->index(row, kQuantityColumn));
+}
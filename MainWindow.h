@@ -7,6 +7,8 @@
 #include <QStandardItemModel>
 #include "InventoryManager.h"
 #include "ReportGenerator.h"
+#include "MemoryBudget.h"
+#include "ScanPipeline.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -33,6 +35,9 @@ private slots:
     /// @param text Texto actual ingresado en el QLineEdit de búsqueda.
     void on_searchLineEdit_textChanged(const QString &text);
 
+    /// @brief Slot que se ejecuta al pulsar Intro en el campo de escaneo (lector de códigos en modo teclado).
+    void on_scanLineEdit_returnPressed();
+
     /// @brief Slot que se ejecuta al pulsar el botón de agregar componente.
     void on_addButton_clicked();
 
@@ -42,30 +47,75 @@ private slots:
     /// @brief Slot que se ejecuta al pulsar el botón de eliminar componente.
     void on_deleteButton_clicked();
 
+    /// @brief Slot que se ejecuta al pulsar el botón de deshacer.
+    void on_undoButton_clicked();
+
+    /// @brief Slot que se ejecuta al pulsar el botón de rehacer.
+    void on_redoButton_clicked();
+
     /// @brief Slot que se ejecuta al pulsar el botón de verificar bajo stock.
     void on_checkLowStockButton_clicked();
 
+    /// @brief Slot que se ejecuta al pulsar el botón de umbral por tipo.
+    void on_typeThresholdButton_clicked();
+
     /// @brief Slot que se ejecuta al pulsar el botón de exportar informe CSV.
     void on_exportCSVButton_clicked();
 
     /// @brief Slot que se ejecuta al pulsar el botón de exportar informe PDF.
     void on_exportPDFButton_clicked();
 
+    /// @brief Slot que se ejecuta al pulsar el botón de exportar en formato columnar.
+    void on_exportColumnarButton_clicked();
+
+    /// @brief Slot que se ejecuta al pulsar el botón de exportar el informe de antigüedad.
+    void on_exportAgingButton_clicked();
+
     /// @brief Actualiza la tabla de componentes en la UI.
-    /// @param components Vector de objetos Component que se mostrarán.
-    void refreshTable(const std::vector<Component> &components);
+    /// @param components Resúmenes de los componentes que se mostrarán.
+    /// @param truncated true si la lista se ha recortado por el límite de filas.
+    void refreshTable(const std::vector<ComponentSummary> &components, bool truncated = false);
+
+    /// @brief Muestra en la barra de estado la alerta de un componente que ha cruzado su umbral.
+    /// @param component Componente con bajo stock.
+    /// @param threshold Umbral efectivo cruzado.
+    void showLowStockAlert(const Component &component, int threshold);
+
+    /// @brief Habilita o deshabilita los botones de deshacer y rehacer.
+    /// @param canUndo true si hay operaciones que deshacer.
+    /// @param canRedo true si hay operaciones que rehacer.
+    void updateUndoRedoButtons(bool canUndo, bool canRedo);
+
+    /// @brief Muestra en la barra de estado el avance de la migración del esquema.
+    /// @param version Versión del esquema en curso.
+    /// @param done Trabajo completado.
+    /// @param total Trabajo total de la fase.
+    void showMigrationProgress(int version, qint64 done, qint64 total);
+
+    /// @brief Actualiza en la tabla la cantidad de un componente recién escaneado.
+    /// @param code Código leído.
+    /// @param componentId Componente al que corresponde.
+    /// @param delta Unidades sumadas.
+    void showScan(const QString &code, int componentId, int delta);
 
 private:
     Ui::MainWindow *ui;                 ///< Puntero a la interfaz generada por Qt Designer.
     InventoryManager m_inventory;       ///< Gestor de las operaciones de inventario.
     ReportGenerator m_reporter;         ///< Generador de informes CSV y PDF.
     QStandardItemModel *m_model;        ///< Modelo de datos para la vista de tabla.
+    MemoryAccount m_modelAccount;       ///< Memoria contabilizada del modelo de la tabla.
+    ScanPipeline m_scanPipeline;        ///< Recuento por lector de códigos de barras.
+    QHash<int, int> m_rowById;          ///< Fila de la tabla de cada ID mostrado.
 
     /// @brief Configura el modelo de datos para la tabla de componentes.
     void setupModel();
 
     /// @brief Carga los datos de la base de datos en la tabla de la UI.
     void loadTable();
+
+    /// @brief Número máximo de filas que se materializan según el presupuesto de memoria.
+    /// @return Filas que caben en la memoria disponible, sin superar el máximo de la tabla.
+    int rowLimit() const;
 };
 
 #endif // MAINWINDOW_H
@@ -0,0 +1,198 @@
+/// @file MemoryBudget.cpp
+/// @brief Implementación del presupuesto global de memoria.
+
+#include "MemoryBudget.h"
+#include <QDebug>
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace {
+/// Coste fijo aproximado de un QString no vacío (cabecera compartida y terminador).
+const qint64 kStringOverhead = 24;
+}
+
+/// @brief Presupuesto compartido por toda la aplicación.
+/// @return Instancia única, creada en el primer uso.
+MemoryBudget &MemoryBudget::global()
+{
+    static MemoryBudget budget;
+    return budget;
+}
+
+/// @brief Constructor: toma el límite inicial de GESTOR_INVENTARIO_MEMORIA_MB.
+MemoryBudget::MemoryBudget()
+    : m_limit(qMax<qint64>(0, qgetenv("GESTOR_INVENTARIO_MEMORIA_MB").toLongLong()) * 1024 * 1024)
+    , m_usage(0)
+    , m_nextHandle(1)
+{}
+
+/// @brief Establece el límite y lo aplica de inmediato.
+/// @param bytes Límite en bytes; 0 o negativo lo desactiva.
+void MemoryBudget::setLimit(qint64 bytes)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_limit = qMax<qint64>(0, bytes);
+    enforceLocked();
+}
+
+/// @brief Límite de memoria en bytes.
+qint64 MemoryBudget::limit() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_limit;
+}
+
+/// @brief Bytes contabilizados por todos los consumidores.
+qint64 MemoryBudget::usage() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_usage;
+}
+
+/// @brief Bytes que aún caben en el presupuesto.
+qint64 MemoryBudget::available() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_limit == 0)
+        return std::numeric_limits<qint64>::max();
+    return qMax<qint64>(0, m_limit - m_usage);
+}
+
+/// @brief Uso agrupado por nombre de consumidor.
+/// @return Tabla nombre → bytes.
+QMap<QString, qint64> MemoryBudget::report() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    QMap<QString, qint64> usage;
+    for (const auto &entry : m_consumers)
+        usage[entry.second.name] += entry.second.bytes;
+    return usage;
+}
+
+/// @brief Estimación del tamaño en memoria de un componente y sus cadenas.
+/// @param component Componente a medir.
+/// @return Bytes aproximados.
+qint64 MemoryBudget::estimate(const Component &component)
+{
+    return qint64(sizeof(Component))
+           + 6 * kStringOverhead
+           + qint64(component.name().size() + component.type().size() + component.location().size()
+                    + component.notes().size() + component.datasheetUrl().size() + component.barcode().size())
+                 * qint64(sizeof(QChar));
+}
+
+/// @brief Estimación del tamaño en memoria del resumen de un componente.
+/// @param summary Resumen a medir.
+/// @return Bytes aproximados.
+qint64 MemoryBudget::estimate(const ComponentSummary &summary)
+{
+    return qint64(sizeof(ComponentSummary))
+           + 3 * kStringOverhead
+           + qint64(summary.name.size() + summary.type.size() + summary.location.size()) * qint64(sizeof(QChar));
+}
+
+/// @brief Registra un consumidor.
+/// @param name Nombre del consumidor.
+/// @param kind Clase de consumidor.
+/// @param evict Petición de descarte para las cachés.
+/// @return Identificador del consumidor.
+int MemoryBudget::registerConsumer(const QString &name, Kind kind, const std::function<void()> &evict)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Consumer consumer;
+    consumer.name = name;
+    consumer.kind = kind;
+    consumer.evict = evict;
+    consumer.bytes = 0;
+    consumer.evictRequested = false;
+    const int handle = m_nextHandle++;
+    m_consumers[handle] = consumer;
+    return handle;
+}
+
+/// @brief Da de baja un consumidor.
+/// @param handle Identificador devuelto por registerConsumer().
+void MemoryBudget::unregisterConsumer(int handle)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_consumers.find(handle);
+    if (it == m_consumers.end())
+        return;
+    m_usage -= it->second.bytes;
+    m_consumers.erase(it);
+}
+
+/// @brief Actualiza el uso de un consumidor y aplica el presupuesto.
+/// @param handle Identificador del consumidor.
+/// @param bytes Bytes que ocupa ahora.
+void MemoryBudget::setUsage(int handle, qint64 bytes)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_consumers.find(handle);
+    if (it == m_consumers.end())
+        return;
+    m_usage += bytes - it->second.bytes;
+    it->second.bytes = bytes;
+    it->second.evictRequested = false;
+    enforceLocked();
+}
+
+/// @brief Si el uso supera el límite, pide descartar las cachés más grandes hasta cubrir el exceso.
+void MemoryBudget::enforceLocked()
+{
+    if (m_limit == 0 || m_usage <= m_limit)
+        return;
+
+    std::vector<Consumer *> caches;
+    for (auto &entry : m_consumers) {
+        Consumer &consumer = entry.second;
+        if (consumer.kind == Cache && consumer.evict && consumer.bytes > 0 && !consumer.evictRequested)
+            caches.push_back(&consumer);
+    }
+    std::sort(caches.begin(), caches.end(), [](const Consumer *a, const Consumer *b) {
+        return a->bytes > b->bytes;
+    });
+
+    qint64 excess = m_usage - m_limit;
+    for (Consumer *consumer : caches) {
+        if (excess <= 0)
+            break;
+        consumer->evictRequested = true;
+        consumer->evict();
+        excess -= consumer->bytes;
+    }
+    if (excess > 0)
+        qDebug() << "Presupuesto de memoria superado:" << m_usage << "de" << m_limit << "bytes";
+}
+
+/// @brief Registra la cuenta en el presupuesto global.
+/// @param name Nombre del consumidor.
+/// @param kind Clase de consumidor.
+/// @param evict Petición de descarte.
+MemoryAccount::MemoryAccount(const QString &name, MemoryBudget::Kind kind, const std::function<void()> &evict)
+    : m_handle(MemoryBudget::global().registerConsumer(name, kind, evict))
+    , m_bytes(0)
+{}
+
+/// @brief Da de baja la cuenta del presupuesto global.
+MemoryAccount::~MemoryAccount()
+{
+    MemoryBudget::global().unregisterConsumer(m_handle);
+}
+
+/// @brief Actualiza los bytes contabilizados.
+/// @param bytes Bytes que ocupa ahora el consumidor.
+void MemoryAccount::setUsage(qint64 bytes)
+{
+    if (bytes == m_bytes)
+        return;
+    m_bytes = bytes;
+    MemoryBudget::global().setUsage(m_handle, bytes);
+}
+
+/// @brief Bytes contabilizados por esta cuenta.
+qint64 MemoryAccount::usage() const
+{
+    return m_bytes;
+}
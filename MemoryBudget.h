@@ -0,0 +1,125 @@
+/// @file MemoryBudget.h
+/// @brief Declaración de MemoryBudget y MemoryAccount, contabilidad de memoria con presupuesto global.
+
+#ifndef MEMORYBUDGET_H
+#define MEMORYBUDGET_H
+
+#include <QMap>
+#include <QString>
+#include <functional>
+#include <map>
+#include <mutex>
+#include "Component.h"
+
+/// @class MemoryBudget
+/// @brief Presupuesto global de memoria y registro de los consumidores que la ocupan.
+///
+/// Cada consumidor (cachés, modelos de la interfaz, búferes de informes) declara los
+/// bytes que ocupa. Si el total supera el límite, se pide a las cachés, de mayor a menor,
+/// que se descarten hasta cubrir el exceso; los búferes solo se contabilizan. Las
+/// operaciones que materializan resultados consultan available() para limitar el número
+/// de filas o pasar a recorrer los datos en flujo.
+///
+/// El límite por defecto se toma de la variable de entorno GESTOR_INVENTARIO_MEMORIA_MB
+/// (0 o ausente: sin límite). La clase es segura entre hilos.
+class MemoryBudget {
+public:
+    /// @brief Clase de consumidor.
+    enum Kind {
+        Cache,  ///< Puede descartarse y reconstruirse cuando se necesite.
+        Buffer  ///< Solo se contabiliza; no puede liberarse bajo demanda.
+    };
+
+    /// @brief Presupuesto compartido por toda la aplicación.
+    static MemoryBudget &global();
+
+    /// @brief Establece el límite de memoria.
+    /// @param bytes Límite en bytes; 0 o negativo desactiva el límite.
+    void setLimit(qint64 bytes);
+
+    /// @brief Límite de memoria en bytes (0 si no hay límite).
+    qint64 limit() const;
+
+    /// @brief Bytes contabilizados por todos los consumidores.
+    qint64 usage() const;
+
+    /// @brief Bytes disponibles hasta el límite (el máximo de qint64 si no hay límite).
+    qint64 available() const;
+
+    /// @brief Bytes contabilizados agrupados por nombre de consumidor.
+    QMap<QString, qint64> report() const;
+
+    /// @brief Estimación de los bytes que ocupa un componente en memoria.
+    static qint64 estimate(const Component &component);
+
+    /// @brief Estimación de los bytes que ocupa el resumen de un componente en memoria.
+    static qint64 estimate(const ComponentSummary &summary);
+
+    /// @brief Registra un consumidor.
+    /// @param name Nombre con el que aparece en report().
+    /// @param kind Clase de consumidor.
+    /// @param evict Para las cachés, función que solicita descartarlas. Se llama con el
+    ///        registro bloqueado y desde cualquier hilo: solo debe marcar la petición
+    ///        (p. ej. en un std::atomic) para que el propietario la atienda en su hilo.
+    /// @return Identificador del consumidor.
+    int registerConsumer(const QString &name, Kind kind, const std::function<void()> &evict = std::function<void()>());
+
+    /// @brief Elimina un consumidor y su uso del registro.
+    void unregisterConsumer(int handle);
+
+    /// @brief Actualiza los bytes de un consumidor y aplica el presupuesto si se supera.
+    void setUsage(int handle, qint64 bytes);
+
+private:
+    MemoryBudget();
+    MemoryBudget(const MemoryBudget &) = delete;
+    MemoryBudget &operator=(const MemoryBudget &) = delete;
+
+    /// @brief Consumidor registrado.
+    struct Consumer {
+        QString name;                ///< Nombre del consumidor.
+        Kind kind;                   ///< Clase de consumidor.
+        std::function<void()> evict; ///< Petición de descarte (solo cachés).
+        qint64 bytes;                ///< Bytes contabilizados.
+        bool evictRequested;         ///< Ya se ha pedido el descarte y no ha cambiado el uso.
+    };
+
+    /// @brief Pide el descarte de cachés hasta cubrir el exceso (con m_mutex bloqueado).
+    void enforceLocked();
+
+    mutable std::mutex m_mutex;        ///< Protege los campos siguientes.
+    std::map<int, Consumer> m_consumers; ///< Consumidores por identificador.
+    qint64 m_limit;                    ///< Límite en bytes (0 = sin límite).
+    qint64 m_usage;                    ///< Suma de bytes de los consumidores.
+    int m_nextHandle;                  ///< Siguiente identificador libre.
+};
+
+/// @class MemoryAccount
+/// @brief Cuenta de un consumidor en el presupuesto global; se da de baja al destruirse.
+class MemoryAccount {
+public:
+    /// @brief Registra el consumidor en MemoryBudget::global().
+    /// @param name Nombre del consumidor.
+    /// @param kind Clase de consumidor.
+    /// @param evict Petición de descarte (ver MemoryBudget::registerConsumer).
+    MemoryAccount(const QString &name, MemoryBudget::Kind kind,
+                  const std::function<void()> &evict = std::function<void()>());
+
+    /// @brief Da de baja el consumidor.
+    ~MemoryAccount();
+
+    /// @brief Actualiza los bytes contabilizados.
+    void setUsage(qint64 bytes);
+
+    /// @brief Bytes contabilizados por esta cuenta.
+    qint64 usage() const;
+
+private:
+    MemoryAccount(const MemoryAccount &) = delete;
+    MemoryAccount &operator=(const MemoryAccount &) = delete;
+
+    int m_handle;   ///< Identificador en el presupuesto global.
+    qint64 m_bytes; ///< Último uso declarado.
+};
+
+#endif // MEMORYBUDGET_H
@@ -2,7 +2,13 @@
 /// @brief Implementación de los métodos de la clase ReportGenerator para generación de informes en CSV y PDF.
 
 #include "ReportGenerator.h"
+#include "ColumnarWriter.h"
+#include "ComponentSchema.h"
+#include "DatabaseManager.h"
+#include "GzipDevice.h"
+#include "MemoryBudget.h"
 #include <QFile>
+#include <QSaveFile>
 #include <QTextStream>
 #include <QPdfWriter>
 #include <QPainter>
@@ -14,10 +20,17 @@
 #include <QPdfWriter>
 #include <QPainter>
 
+namespace {
+/// Coste aproximado de una celda de QTextTable (bloque, formato y fragmento) sin su texto.
+const qint64 kPdfCellBytes = 256;
+}
+
 /// @brief Constructor de ReportGenerator.
 /// @param parent Objeto padre en la jerarquía de Qt (por defecto nullptr).
 ReportGenerator::ReportGenerator(QObject *parent)
     : QObject(parent)
+    , m_compression(AutoCompression)
+    , m_compressionLevel(-1)
 {}
 
 /// @brief Destructor de ReportGenerator.
@@ -29,32 +42,48 @@ ReportGenerator::~ReportGenerator()
 /// @param components Vector de objetos Component que se incluirán en el informe.
 /// @return true si el archivo CSV se abre y escribe correctamente; false en caso de fallo al abrir o escribir.
 bool ReportGenerator::generateCSV(const QString &filePath, const std::vector<Component> &components) {
-    QFile file(filePath);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
-        return false;
+    return generateCSV(filePath, [&components](const std::function<bool(const Component &)> &visitor) -> bool {
+        for (const auto &c : components) {
+            if (!visitor(c))
+                break;
+        }
+        return true;
+    });
+}
 
-    QTextStream out(&file);
-    // Cabecera del CSV
-    out << "ID,Nombre,Tipo,Cantidad,Ubicacion,FechaCompra\n";
-    // Filas con los datos de cada componente
-    for (const auto &c : components) {
-        out << c.id() << ","
-            << c.name() << ","
-            << c.type() << ","
-            << c.quantity() << ","
-            << c.location() << ","
-            << c.purchaseDate().toString(Qt::ISODate) << "\n";
-    }
-    file.close();
-    return true;
+/// @brief Genera un informe CSV a partir de un origen de filas en flujo.
+/// @param filePath Ruta completa donde se guardará el archivo CSV.
+/// @param source Origen de filas que entrega cada componente.
+/// @return true si el archivo CSV se escribe correctamente; false en caso de error.
+bool ReportGenerator::generateCSV(const QString &filePath, const ComponentSource &source) {
+    return writeFile(filePath, [&source](QIODevice *device) -> bool {
+        QTextStream out(device);
+        // Cabecera del CSV
+        out << ComponentSchema::ListFields::labels(true).join(',') << "\n";
+        // Filas con los datos de cada componente
+        const bool ok = source([&out](const Component &c) -> bool {
+            ComponentSchema::ListFields::writeCsv(out, c);
+            out << "\n";
+            return out.status() == QTextStream::Ok;
+        });
+        out.flush();
+        return ok && out.status() == QTextStream::Ok;
+    });
 }
 
 /// @brief Genera un informe en formato PDF con la lista de componentes proporcionada.
 /// @param filePath Ruta completa (incluyendo nombre y extensión) donde se guardará el archivo PDF.
-/// @param components Vector de objetos Component que se incluirán en el informe.
+/// @param components Resúmenes de los componentes que se incluirán en el informe.
 /// @return true si el PDF se genera y guarda correctamente; false en caso de error durante la generación.
-bool ReportGenerator::generatePDF(const QString &filePath, const std::vector<Component> &components) {
-QPdfWriter writer(filePath);
+bool ReportGenerator::generatePDF(const QString &filePath, const std::vector<ComponentSummary> &components) {
+    // El documento se construye entero en memoria antes de imprimirse
+    MemoryAccount account("Informe PDF", MemoryBudget::Buffer);
+    qint64 documentBytes = 0;
+    for (const auto &c : components)
+        documentBytes += ComponentSchema::ListFields::size * kPdfCellBytes + MemoryBudget::estimate(c);
+    account.setUsage(documentBytes);
+
+    QPdfWriter writer(filePath);
     writer.setPageSize(QPagedPaintDevice::A4);
     writer.setResolution(300);
 
@@ -71,33 +100,101 @@ QPdfWriter writer(filePath);
     tableFormat.setCellSpacing(0);
     tableFormat.setBorder(1);
 
-    QTextTable *table = cursor.insertTable(components.size() + 1, 6, tableFormat);
+    QTextTable *table = cursor.insertTable(components.size() + 1, ComponentSchema::ListFields::size, tableFormat);
 
     // Cabeceras
-    QStringList headers = {"ID", "Nombre", "Tipo", "Cantidad", "Ubicación", "Fecha Compra"};
+    const QStringList headers = ComponentSchema::ListFields::labels();
     for (const QString &header : headers) {
         cursor.insertText(header);
         cursor.movePosition(QTextCursor::NextCell);
     }
 
     // Datos
-    for (const auto &c : components) {
-        cursor.insertText(QString::number(c.id()));
-        cursor.movePosition(QTextCursor::NextCell);
-        cursor.insertText(c.name());
-        cursor.movePosition(QTextCursor::NextCell);
-        cursor.insertText(c.type());
-        cursor.movePosition(QTextCursor::NextCell);
-        cursor.insertText(QString::number(c.quantity()));
+    auto insertCell = [&cursor](int, const QString &text) {
+        cursor.insertText(text);
         cursor.movePosition(QTextCursor::NextCell);
-        cursor.insertText(c.location());
-        cursor.movePosition(QTextCursor::NextCell);
-        cursor.insertText(c.purchaseDate().toString(Qt::ISODate));
-        cursor.movePosition(QTextCursor::NextCell);
-    }
+    };
+    for (const auto &c : components)
+        ComponentSchema::ListFields::forEachText(c, insertCell);
 
     doc.setPageSize(QSizeF(writer.width(), writer.height()));
     doc.print(&writer);
 
     return true;
 }
+
+/// @brief Genera un archivo columnar GICF a partir de un origen de filas en flujo.
+/// @param filePath Ruta completa donde se guardará el archivo.
+/// @param source Origen de filas que entrega cada componente al escritor.
+/// @return true si el archivo se escribe y confirma correctamente; false en caso de error.
+bool ReportGenerator::generateColumnar(const QString &filePath, const ComponentSource &source) {
+    return writeFile(filePath, [&source](QIODevice *device) -> bool {
+        ColumnarWriter writer;
+        bool ok = writer.open(device);
+        ok = ok && source([&writer, &ok](const Component &c) -> bool {
+            ok = writer.append(c);
+            return ok;
+        });
+        return ok && writer.finish();
+    });
+}
+
+/// @brief Genera el informe CSV de antigüedad en formato largo (tipo, franja, componentes, unidades).
+/// @param filePath Ruta completa donde se guardará el archivo CSV.
+/// @param histogram Histograma de antigüedad por tipo.
+/// @return true si el archivo CSV se escribe correctamente; false en caso de error.
+bool ReportGenerator::generateAgingReport(const QString &filePath, const AgingHistogram &histogram) {
+    return writeFile(filePath, [&histogram](QIODevice *device) -> bool {
+        QTextStream out(device);
+        out << "Tipo,Franja,Componentes,Unidades\n";
+        for (auto it = histogram.byType.constBegin(); it != histogram.byType.constEnd(); ++it) {
+            for (std::size_t i = 0; i < it.value().size(); ++i) {
+                const AgingBucket &bucket = it.value()[i];
+                out << it.key() << ',' << histogram.bucketLabel(i) << ','
+                    << bucket.components << ',' << bucket.units << "\n";
+            }
+        }
+        out << ",Sin fecha," << histogram.undated << ",\n";
+        out.flush();
+        return out.status() == QTextStream::Ok;
+    });
+}
+
+/// @brief Configura la compresión de las exportaciones CSV y columnar.
+/// @param mode Modo de compresión.
+/// @param level Nivel de gzip (-1 a 9).
+void ReportGenerator::setCompression(Compression mode, int level) {
+    m_compression = mode;
+    m_compressionLevel = qBound(-1, level, 9);
+}
+
+/// @brief Escribe un archivo a través de un QSaveFile, intercalando un GzipDevice si se comprime.
+///        El archivo final solo se reemplaza si la escritura y la compresión terminan bien.
+/// @param filePath Ruta del archivo.
+/// @param body Función que escribe el contenido.
+/// @return true si el archivo se confirma correctamente; false en caso de error.
+bool ReportGenerator::writeFile(const QString &filePath, const std::function<bool(QIODevice *)> &body) {
+    const bool gzip = m_compression == GzipCompression
+                      || (m_compression == AutoCompression && GzipDevice::isGzipPath(filePath));
+    QSaveFile file(filePath);
+    if (!file.open(gzip ? QIODevice::WriteOnly : QIODevice::WriteOnly | QIODevice::Text))
+        return false;
+
+    bool ok = false;
+    if (gzip) {
+        GzipDevice compressed(&file, m_compressionLevel);
+        if (compressed.open(QIODevice::WriteOnly)) {
+            ok = body(&compressed);
+            compressed.close();
+            ok = ok && !compressed.hasError();
+        }
+    } else {
+        ok = body(&file);
+    }
+
+    if (!ok) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
@@ -5,18 +5,36 @@
 
 #include <QObject>
 #include <QString>
+#include <functional>
 #include <vector>
 #include "Component.h"
 
+class QIODevice;
+struct AgingHistogram;
+
+/// @brief Origen de filas para los informes en flujo: llama al visitante con cada componente
+///        (el visitante devuelve false para detener el recorrido) y devuelve false si falla.
+typedef std::function<bool(const std::function<bool(const Component &)> &)> ComponentSource;
+
 /// @class ReportGenerator
 /// @brief Clase responsable de generar informes en distintos formatos a partir de una lista de componentes.
 ///
 /// Esta clase proporciona métodos para exportar la información de los componentes
-/// a archivos CSV y PDF, permitiendo su visualización y análisis externos.
+/// a archivos CSV y PDF, permitiendo su visualización y análisis externos, y al
+/// formato columnar tipado GICF (ver ColumnarWriter) para análisis de datos.
+/// Las exportaciones CSV y columnar pueden comprimirse en gzip mientras se escriben
+/// (ver setCompression); la compresión se hace en un hilo aparte (ver GzipDevice).
 class ReportGenerator : public QObject {
     Q_OBJECT
 
 public:
+    /// @brief Compresión de las exportaciones CSV y columnar.
+    enum Compression {
+        AutoCompression, ///< gzip si la ruta termina en .gz; sin comprimir en otro caso.
+        NoCompression,   ///< Nunca comprimir.
+        GzipCompression  ///< Comprimir siempre en gzip.
+    };
+
     /// @brief Constructor de ReportGenerator.
     /// @param parent Objeto padre en la jerarquía de Qt (por defecto nullptr).
     explicit ReportGenerator(QObject *parent = nullptr);
@@ -30,11 +48,47 @@ public:
     /// @return true si el archivo CSV se genera y guarda correctamente; false en caso de error.
     bool generateCSV(const QString &filePath, const std::vector<Component> &components);
 
+    /// @brief Genera un informe CSV leyendo las filas en flujo desde el origen.
+    /// @param filePath Ruta donde se guardará el archivo CSV (con .gz, comprimido en modo automático).
+    /// @param source Origen de filas (p. ej. InventoryManager::forEachComponent).
+    /// @return true si el archivo CSV se genera correctamente; false en caso de error.
+    bool generateCSV(const QString &filePath, const ComponentSource &source);
+
     /// @brief Genera un informe en formato PDF con la lista de componentes proporcionada.
     /// @param filePath Ruta (incluyendo nombre y extensión) donde se guardará el archivo PDF.
-    /// @param components Vector de objetos Component que se incluirán en el informe.
+    /// @param components Resúmenes de los componentes que se incluirán en el informe.
     /// @return true si el archivo PDF se genera y guarda correctamente; false en caso de error.
-    bool generatePDF(const QString &filePath, const std::vector<Component> &components);
+    bool generatePDF(const QString &filePath, const std::vector<ComponentSummary> &components);
+
+    /// @brief Genera un archivo columnar GICF leyendo las filas en flujo desde el origen.
+    ///        Las filas se escriben por grupos, sin cargar todo el inventario en memoria.
+    /// @param filePath Ruta donde se guardará el archivo.
+    /// @param source Origen de filas (p. ej. InventoryManager::forEachComponent).
+    /// @return true si el archivo se genera correctamente; false en caso de error.
+    bool generateColumnar(const QString &filePath, const ComponentSource &source);
+
+    /// @brief Genera un informe CSV de antigüedad: una fila por tipo y franja de días desde la
+    ///        compra, con el número de componentes y de unidades, más una fila de los que no tienen fecha.
+    /// @param filePath Ruta donde se guardará el archivo CSV (con .gz, comprimido en modo automático).
+    /// @param histogram Histograma calculado con InventoryManager::agingHistogram().
+    /// @return true si el archivo CSV se genera correctamente; false en caso de error.
+    bool generateAgingReport(const QString &filePath, const AgingHistogram &histogram);
+
+    /// @brief Configura la compresión de las exportaciones CSV y columnar.
+    /// @param mode Modo de compresión (por defecto, según la extensión del archivo).
+    /// @param level Nivel de gzip de 0 a 9; -1 usa el nivel por defecto de zlib.
+    void setCompression(Compression mode, int level = -1);
+
+private:
+    /// @brief Abre el archivo de destino (comprimido si corresponde), ejecuta la escritura
+    ///        y solo reemplaza el archivo final si todo es correcto.
+    /// @param filePath Ruta del archivo.
+    /// @param body Función que escribe el contenido en el dispositivo recibido.
+    /// @return true si el archivo se escribe y confirma correctamente.
+    bool writeFile(const QString &filePath, const std::function<bool(QIODevice *)> &body);
+
+    Compression m_compression; ///< Modo de compresión de las exportaciones.
+    int m_compressionLevel;    ///< Nivel de gzip (-1 a 9).
 };
 
 #endif // REPORTGENERATOR_H
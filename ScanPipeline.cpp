@@ -0,0 +1,121 @@
+/// @file ScanPipeline.cpp
+/// @brief Implementación de la entrada de lecturas de códigos de barras con confirmación por lotes.
+
+#include "ScanPipeline.h"
+#include "InventoryManager.h"
+
+/// @brief Constructor de ScanPipeline.
+/// @param inventory Inventario al que se aplican los ajustes.
+/// @param parent Objeto padre en la jerarquía de Qt.
+ScanPipeline::ScanPipeline(InventoryManager *inventory, QObject *parent)
+    : QObject(parent)
+    , m_inventory(inventory)
+    , m_pendingScans(0)
+    , m_intervalMs(500)
+    , m_maxPendingScans(200)
+{
+    m_flushTimer.setSingleShot(true);
+    connect(&m_flushTimer, &QTimer::timeout, this, &ScanPipeline::flush);
+}
+
+/// @brief Destructor de ScanPipeline. Confirma los ajustes que queden pendientes.
+ScanPipeline::~ScanPipeline()
+{
+    flush();
+}
+
+/// @brief Configura el intervalo y el tamaño máximo de los lotes.
+/// @param intervalMs Intervalo máximo en ms (mínimo 0: confirmar cada lectura).
+/// @param maxPendingScans Lecturas que fuerzan la confirmación (mínimo 1).
+void ScanPipeline::setFlushPolicy(int intervalMs, int maxPendingScans)
+{
+    m_intervalMs = intervalMs < 0 ? 0 : intervalMs;
+    m_maxPendingScans = maxPendingScans < 1 ? 1 : maxPendingScans;
+}
+
+/// @brief Resuelve el código, acumula el ajuste y confirma el lote si toca.
+/// @param code Código leído.
+/// @param delta Unidades a sumar.
+/// @return true si el código es conocido.
+bool ScanPipeline::scan(const QString &code, int delta)
+{
+    const QString key = code.trimmed();
+    auto cached = m_idByCode.constFind(key);
+    int id = -1;
+    if (cached != m_idByCode.constEnd()) {
+        id = cached.value();
+    } else if (m_inventory->componentIdForBarcode(key, id)) {
+        m_idByCode.insert(key, id);
+    } else {
+        emit unknownCode(key);
+        return false;
+    }
+
+    if (m_pendingScans == 0)
+        m_age.start();
+    m_pending[id] += delta;
+    ++m_pendingScans;
+    emit scanned(key, id, delta);
+
+    if (m_pendingScans >= m_maxPendingScans || m_age.elapsed() >= m_intervalMs)
+        flush();
+    else if (!m_flushTimer.isActive())
+        m_flushTimer.start(m_intervalMs);
+    return true;
+}
+
+/// @brief Aplica los ajustes acumulados en una transacción por fragmento.
+///        Los ajustes de los fragmentos cuya transacción falla se conservan para el
+///        siguiente intento; los demás ya están confirmados y no se repiten. Los de
+///        componentes eliminados después de leerlos se descartan, porque harían fallar
+///        el lote de su fragmento en cada intento.
+/// @return true si no hay nada pendiente o el lote se confirma.
+bool ScanPipeline::flush()
+{
+    m_flushTimer.stop();
+    if (m_pending.isEmpty())
+        return true;
+
+    const int components = m_pending.size();
+    const int scans = m_pendingScans;
+    QHash<int, int> failed;
+    const bool ok = m_inventory->adjustQuantities(m_pending, &failed);
+    m_pending.swap(failed);
+    bool removed = false;
+    for (auto it = m_pending.begin(); it != m_pending.end();) {
+        Component component;
+        if (m_inventory->getComponent(it.key(), component)) {
+            ++it;
+        } else {
+            it = m_pending.erase(it);
+            removed = true;
+        }
+    }
+    if (removed)
+        clearCache();
+    m_pendingScans = m_pending.isEmpty() ? 0 : m_pendingScans;
+    if (!m_pending.isEmpty())
+        m_age.start();
+    emit flushed(ok, components, scans);
+    return ok;
+}
+
+/// @brief Lecturas pendientes de confirmar.
+int ScanPipeline::pendingScans() const
+{
+    return m_pendingScans;
+}
+
+/// @brief Ajuste pendiente de un componente.
+/// @param id Identificador del componente.
+/// @return Unidades sin confirmar (0 si no hay).
+int ScanPipeline::pendingDelta(int id) const
+{
+    return m_pending.value(id, 0);
+}
+
+/// @brief Vacía la caché de códigos resueltos.
+void ScanPipeline::clearCache()
+{
+    m_idByCode.clear();
+}
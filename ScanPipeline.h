@@ -0,0 +1,93 @@
+/// @file ScanPipeline.h
+/// @brief Declaración de la clase ScanPipeline, entrada de lecturas de códigos de barras para recuentos.
+
+#ifndef SCANPIPELINE_H
+#define SCANPIPELINE_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QString>
+#include <QTimer>
+
+class InventoryManager;
+
+/// @class ScanPipeline
+/// @brief Acumula en memoria los ajustes de stock de las lecturas y los confirma por lotes.
+///
+/// Cada lectura se resuelve a un ID (con una caché y, si falla, con el índice único de la
+/// columna barcode) y suma su cantidad a un ajuste pendiente por componente, sin tocar la
+/// base de datos. Los ajustes se aplican con InventoryManager::adjustQuantities() en una
+/// transacción por fragmento cuando pasa el intervalo de confirmación o se acumulan
+/// demasiadas lecturas, de modo que el coste por lectura es una búsqueda en memoria.
+///
+/// El intervalo se comprueba en cada lectura y, durante las pausas, con un temporizador,
+/// que necesita el bucle de eventos: --scan lee la entrada estándar en un hilo aparte para
+/// no bloquearlo.
+class ScanPipeline : public QObject {
+    Q_OBJECT
+
+public:
+    /// @brief Constructor de ScanPipeline.
+    /// @param inventory Inventario al que se aplican los ajustes (no se toma su propiedad).
+    /// @param parent Objeto padre en la jerarquía de Qt (por defecto nullptr).
+    explicit ScanPipeline(InventoryManager *inventory, QObject *parent = nullptr);
+
+    /// @brief Destructor de ScanPipeline. Confirma los ajustes pendientes.
+    ~ScanPipeline();
+
+    /// @brief Configura cuándo se confirman los ajustes acumulados.
+    /// @param intervalMs Tiempo máximo (ms) que una lectura permanece sin confirmar.
+    /// @param maxPendingScans Lecturas que fuerzan la confirmación inmediata.
+    void setFlushPolicy(int intervalMs, int maxPendingScans);
+
+    /// @brief Registra una lectura.
+    /// @param code Código de barras leído (se ignoran los espacios de los extremos).
+    /// @param delta Unidades a sumar (por defecto 1; negativo para descontar).
+    /// @return true si el código corresponde a un componente; false si es desconocido.
+    bool scan(const QString &code, int delta = 1);
+
+    /// @brief Aplica los ajustes pendientes en la base de datos.
+    /// @return true si no hay ajustes o se confirman correctamente; false en caso de error.
+    bool flush();
+
+    /// @brief Lecturas registradas pendientes de confirmar.
+    int pendingScans() const;
+
+    /// @brief Ajuste pendiente de un componente.
+    /// @param id Identificador del componente.
+    /// @return Unidades aún sin confirmar.
+    int pendingDelta(int id) const;
+
+    /// @brief Olvida los códigos resueltos (p. ej. tras reasignar códigos de barras).
+    void clearCache();
+
+signals:
+    /// @brief Se emite con cada lectura de un código conocido.
+    /// @param code Código leído.
+    /// @param componentId Componente al que corresponde.
+    /// @param delta Unidades sumadas por esta lectura.
+    void scanned(const QString &code, int componentId, int delta);
+
+    /// @brief Se emite cuando se lee un código que no tiene ningún componente asignado.
+    /// @param code Código leído.
+    void unknownCode(const QString &code);
+
+    /// @brief Se emite tras confirmar un lote.
+    /// @param ok true si el lote se confirma correctamente.
+    /// @param components Componentes ajustados en el lote.
+    /// @param scans Lecturas incluidas en el lote.
+    void flushed(bool ok, int components, int scans);
+
+private:
+    InventoryManager *m_inventory;   ///< Inventario destino.
+    QHash<QString, int> m_idByCode;  ///< Caché de códigos resueltos.
+    QHash<int, int> m_pending;       ///< Ajuste pendiente por ID.
+    int m_pendingScans;              ///< Lecturas pendientes de confirmar.
+    int m_intervalMs;                ///< Intervalo máximo sin confirmar.
+    int m_maxPendingScans;           ///< Lecturas que fuerzan la confirmación.
+    QElapsedTimer m_age;             ///< Tiempo desde la primera lectura pendiente.
+    QTimer m_flushTimer;             ///< Confirma el lote cuando hay bucle de eventos.
+};
+
+#endif // SCANPIPELINE_H
@@ -0,0 +1,561 @@
+/// @file ServerWorker.cpp
+/// @brief Implementación del trabajador HTTP que expone InventoryManager en formato JSON.
+
+#include "ServerWorker.h"
+#include "ComponentSchema.h"
+#include "InventoryManager.h"
+#include "MemoryBudget.h"
+#include <QTcpSocket>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QUrl>
+#include <QStringList>
+
+namespace {
+/// Tamaño máximo aceptado para cabeceras y cuerpo de una petición.
+const int kMaxRequestBytes = 1 << 20;
+/// Tamaño objetivo de cada trozo de una respuesta chunked.
+const int kChunkBytes = 64 * 1024;
+/// Datos pendientes de envío a partir de los cuales se espera al cliente.
+const qint64 kMaxPendingOutput = 4 * 1024 * 1024;
+/// Número máximo de componentes de una búsqueda, de /lowstock o de /purchases.
+const int kMaxResultRows = 10000;
+
+/// @brief Límite de filas pedido con ?limit=N, acotado por kMaxResultRows.
+int resultLimit(const QUrlQuery &query)
+{
+    const int limit = query.queryItemValue("limit").toInt();
+    return limit > 0 && limit < kMaxResultRows ? limit : kMaxResultRows;
+}
+
+/// @brief Texto de estado HTTP para los códigos usados por el servidor.
+QByteArray statusText(int status)
+{
+    switch (status) {
+    case 200: return "OK";
+    case 400: return "Bad Request";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 413: return "Payload Too Large";
+    default:  return "Internal Server Error";
+    }
+}
+
+/// @brief Cuerpo JSON de error.
+QByteArray errorJson(const QString &message)
+{
+    QJsonObject error;
+    error.insert("error", message);
+    return QJsonDocument(error).toJson(QJsonDocument::Compact);
+}
+
+/// @brief Construye el objeto JSON de un componente.
+QJsonObject componentObject(const Component &component)
+{
+    // Las columnas opcionales vacías se omiten
+    QJsonObject object;
+    ComponentSchema::StoredFields::insertJson(object, component);
+    return object;
+}
+}
+
+/// @brief Constructor de ServerWorker.
+/// @param dbPath Ruta de la base de datos.
+/// @param connectionName Nombre de la conexión SQLite propia del trabajador.
+/// @param shards Fragmentos por almacén.
+/// @param parent Objeto padre en la jerarquía de Qt.
+ServerWorker::ServerWorker(const QString &dbPath, const QString &connectionName,
+                           const std::vector<ShardSpec> &shards, QObject *parent)
+    : QObject(parent)
+    , m_dbPath(dbPath)
+    , m_connectionName(connectionName)
+    , m_shards(shards)
+    , m_inventory(nullptr)
+{}
+
+/// @brief Destructor de ServerWorker.
+///        El inventario y los sockets son hijos del trabajador y se destruyen con él.
+ServerWorker::~ServerWorker()
+{}
+
+/// @brief Crea el socket del cliente en el hilo del trabajador y conecta sus señales.
+/// @param socketDescriptor Descriptor nativo aceptado por InventoryServer.
+void ServerWorker::handleConnection(qintptr socketDescriptor)
+{
+    QTcpSocket *socket = new QTcpSocket(this);
+    if (!socket->setSocketDescriptor(socketDescriptor)) {
+        delete socket;
+        return;
+    }
+    m_buffers.insert(socket, QByteArray());
+    connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { readClient(socket); });
+    connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+        m_buffers.remove(socket);
+        socket->deleteLater();
+    });
+}
+
+/// @brief Acumula los datos recibidos y atiende cada petición completa (admite peticiones encadenadas).
+/// @param socket Conexión del cliente.
+void ServerWorker::readClient(QTcpSocket *socket)
+{
+    // Se trabaja sobre una copia: al responder, waitForBytesWritten puede emitir disconnected
+    // y su manejador elimina la entrada de m_buffers
+    auto pending = m_buffers.find(socket);
+    if (pending == m_buffers.end())
+        return;
+    QByteArray buffer;
+    buffer.swap(pending.value());
+    buffer.append(socket->readAll());
+
+    HttpRequest request;
+    bool error = false;
+    while (takeRequest(buffer, request, error)) {
+        dispatch(socket, request);
+        if (!m_buffers.contains(socket))
+            return;
+        if (!request.keepAlive) {
+            socket->disconnectFromHost();
+            return;
+        }
+    }
+    pending = m_buffers.find(socket);
+    if (pending == m_buffers.end())
+        return;
+    pending.value() = buffer;
+    if (error) {
+        writeResponse(socket, 400, "application/json", errorJson("Peticion mal formada"), false);
+        socket->disconnectFromHost();
+    } else if (buffer.size() > kMaxRequestBytes) {
+        writeResponse(socket, 413, "application/json", errorJson("Peticion demasiado grande"), false);
+        socket->disconnectFromHost();
+    }
+}
+
+/// @brief Analiza la línea de petición, las cabeceras y el cuerpo (Content-Length).
+/// @param buffer Búfer de entrada; se eliminan los bytes de la petición extraída.
+/// @param request Petición resultante.
+/// @param error true si la petición no es HTTP válido.
+/// @return true si había una petición completa en el búfer.
+bool ServerWorker::takeRequest(QByteArray &buffer, HttpRequest &request, bool &error)
+{
+    const int headerEnd = buffer.indexOf("\r\n\r\n");
+    if (headerEnd < 0)
+        return false;
+
+    const QList<QByteArray> lines = buffer.left(headerEnd).split('\n');
+    const QList<QByteArray> requestLine = lines.first().trimmed().split(' ');
+    if (requestLine.size() != 3 || !requestLine.at(2).startsWith("HTTP/1.")) {
+        error = true;
+        return false;
+    }
+
+    const bool http11 = requestLine.at(2) == "HTTP/1.1";
+    bool keepAlive = http11;
+    int contentLength = 0;
+    for (int i = 1; i < lines.size(); ++i) {
+        const int colon = lines.at(i).indexOf(':');
+        if (colon <= 0)
+            continue;
+        const QByteArray name = lines.at(i).left(colon).trimmed().toLower();
+        const QByteArray value = lines.at(i).mid(colon + 1).trimmed();
+        if (name == "content-length") {
+            contentLength = value.toInt();
+        } else if (name == "connection") {
+            const QByteArray token = value.toLower();
+            if (token == "close")
+                keepAlive = false;
+            else if (token == "keep-alive")
+                keepAlive = true;
+        }
+    }
+    if (contentLength < 0 || contentLength > kMaxRequestBytes) {
+        error = true;
+        return false;
+    }
+
+    const int bodyStart = headerEnd + 4;
+    if (buffer.size() < bodyStart + contentLength)
+        return false;
+
+    const QUrl url(QString::fromLatin1(requestLine.at(1)));
+    request.method = requestLine.at(0);
+    request.path = url.path();
+    request.query = QUrlQuery(url);
+    request.body = buffer.mid(bodyStart, contentLength);
+    request.keepAlive = keepAlive;
+    buffer.remove(0, bodyStart + contentLength);
+    return true;
+}
+
+/// @brief Enruta la petición a la operación del inventario correspondiente.
+/// @param socket Conexión del cliente.
+/// @param request Petición a atender.
+void ServerWorker::dispatch(QTcpSocket *socket, const HttpRequest &request)
+{
+    const bool keepAlive = request.keepAlive;
+    if (!ensureInventory()) {
+        writeResponse(socket, 500, "application/json", errorJson("Base de datos no disponible"), keepAlive);
+        return;
+    }
+
+    const QStringList parts = request.path.split('/', Qt::SkipEmptyParts);
+    const bool isGet = request.method == "GET";
+    const bool isPost = request.method == "POST";
+
+    if (parts.size() == 1 && parts.at(0) == "components") {
+        if (!isGet)
+            return writeResponse(socket, 405, "application/json", errorJson("Metodo no permitido"), keepAlive);
+        const QString keyword = request.query.queryItemValue("q", QUrl::FullyDecoded);
+        if (keyword.isEmpty()) {
+            // Todo el inventario: se recorre con cursor y se envía por trozos, con la misma
+            // proyección ligera que las búsquedas (el detalle está en /components/{id})
+            beginChunked(socket, "application/json", keepAlive);
+            QByteArray chunk("[");
+            bool first = true;
+            m_inventory->forEachComponent([&](const Component &c) -> bool {
+                if (!first)
+                    chunk.append(',');
+                first = false;
+                chunk.append(summaryJson(ComponentSummary(c)));
+                if (chunk.size() >= kChunkBytes) {
+                    writeChunk(socket, chunk);
+                    chunk.clear();
+                }
+                return socket->state() == QAbstractSocket::ConnectedState;
+            });
+            chunk.append(']');
+            writeChunk(socket, chunk);
+            endChunked(socket);
+            return;
+        }
+        if (request.query.queryItemValue("fuzzy") == "1") {
+            const int limit = request.query.queryItemValue("limit").toInt();
+            return streamComponents(socket, m_inventory->fuzzySearch(keyword, limit > 0 ? resultLimit(request.query) : 20),
+                                    keepAlive);
+        }
+        bool truncated = false;
+        const std::vector<ComponentSummary> results =
+            m_inventory->searchComponents(keyword, resultLimit(request.query), &truncated);
+        return streamComponents(socket, results, keepAlive, truncated);
+    }
+
+    if (parts.size() >= 2 && parts.at(0) == "components") {
+        bool validId = false;
+        const int id = parts.at(1).toInt(&validId);
+        if (!validId)
+            return writeResponse(socket, 400, "application/json", errorJson("ID no valido"), keepAlive);
+
+        if (parts.size() == 2 && isGet) {
+            Component c;
+            if (!m_inventory->getComponent(id, c))
+                return writeResponse(socket, 404, "application/json", errorJson("Componente no encontrado"), keepAlive);
+            return writeResponse(socket, 200, "application/json", componentJson(c), keepAlive);
+        }
+
+        if (parts.size() == 3 && parts.at(2) == "adjust") {
+            if (!isPost)
+                return writeResponse(socket, 405, "application/json", errorJson("Metodo no permitido"), keepAlive);
+            bool validDelta = false;
+            int delta = request.query.queryItemValue("delta").toInt(&validDelta);
+            if (!validDelta && !request.body.isEmpty()) {
+                const QJsonValue value = QJsonDocument::fromJson(request.body).object().value("delta");
+                validDelta = value.isDouble();
+                delta = value.toInt();
+            }
+            if (!validDelta)
+                return writeResponse(socket, 400, "application/json", errorJson("Falta delta"), keepAlive);
+            Component c;
+            if (!m_inventory->adjustQuantity(id, delta) || !m_inventory->getComponent(id, c))
+                return writeResponse(socket, 404, "application/json", errorJson("Componente no encontrado"), keepAlive);
+            return writeResponse(socket, 200, "application/json", componentJson(c), keepAlive);
+        }
+    }
+
+    if (parts.size() == 1 && parts.at(0) == "lowstock" && isGet) {
+        bool validThreshold = false;
+        const int threshold = request.query.queryItemValue("threshold").toInt(&validThreshold);
+        bool truncated = false;
+        const std::vector<ComponentSummary> results =
+            m_inventory->getLowStockComponents(validThreshold ? threshold : 5, resultLimit(request.query), &truncated);
+        return streamComponents(socket, results, keepAlive, truncated);
+    }
+
+    if (parts.size() == 1 && parts.at(0) == "purchases" && isGet) {
+        const QString type = request.query.queryItemValue("type", QUrl::FullyDecoded);
+        bool truncated = false;
+        std::vector<ComponentSummary> results;
+        if (request.query.hasQueryItem("olderThan")) {
+            bool validDays = false;
+            const int days = request.query.queryItemValue("olderThan").toInt(&validDays);
+            if (!validDays || days < 0)
+                return writeResponse(socket, 400, "application/json", errorJson("olderThan no valido"), keepAlive);
+            results = m_inventory->getComponentsOlderThan(days, type, resultLimit(request.query), &truncated);
+        } else {
+            const QString fromText = request.query.queryItemValue("from");
+            const QString toText = request.query.queryItemValue("to");
+            const QDate from = QDate::fromString(fromText, Qt::ISODate);
+            const QDate to = QDate::fromString(toText, Qt::ISODate);
+            if ((!fromText.isEmpty() && !from.isValid()) || (!toText.isEmpty() && !to.isValid()))
+                return writeResponse(socket, 400, "application/json", errorJson("Fecha no valida (AAAA-MM-DD)"),
+                                     keepAlive);
+            results = m_inventory->getComponentsPurchasedBetween(from, to, type, resultLimit(request.query),
+                                                                 &truncated);
+        }
+        return streamComponents(socket, results, keepAlive, truncated);
+    }
+
+    if (parts.size() == 1 && parts.at(0) == "aging" && isGet) {
+        std::vector<int> bounds;
+        const QString boundsText = request.query.queryItemValue("bounds");
+        if (boundsText.isEmpty()) {
+            bounds = {30, 90, 180, 365};
+        } else {
+            for (const QString &item : boundsText.split(',', Qt::SkipEmptyParts)) {
+                bool validBound = false;
+                const int bound = item.trimmed().toInt(&validBound);
+                if (!validBound || bound < 0)
+                    return writeResponse(socket, 400, "application/json", errorJson("bounds no valido"), keepAlive);
+                bounds.push_back(bound);
+            }
+        }
+        AgingHistogram histogram;
+        if (!m_inventory->agingHistogram(bounds, histogram))
+            return writeResponse(socket, 500, "application/json", errorJson("Error al calcular la antiguedad"),
+                                 keepAlive);
+        QJsonArray labels;
+        for (std::size_t i = 0; i <= histogram.bounds.size(); ++i)
+            labels.append(histogram.bucketLabel(i));
+        QJsonObject types;
+        for (auto it = histogram.byType.constBegin(); it != histogram.byType.constEnd(); ++it) {
+            QJsonArray buckets;
+            for (const AgingBucket &bucket : it.value()) {
+                QJsonObject entry;
+                entry.insert("components", double(bucket.components));
+                entry.insert("units", double(bucket.units));
+                buckets.append(entry);
+            }
+            types.insert(it.key(), buckets);
+        }
+        QJsonObject aging;
+        aging.insert("today", histogram.today.toString(Qt::ISODate));
+        aging.insert("buckets", labels);
+        aging.insert("types", types);
+        aging.insert("undated", double(histogram.undated));
+        return writeResponse(socket, 200, "application/json",
+                             QJsonDocument(aging).toJson(QJsonDocument::Compact), keepAlive);
+    }
+
+    if (parts.size() == 1 && parts.at(0) == "memory" && isGet) {
+        const MemoryBudget &budget = MemoryBudget::global();
+        QJsonObject consumers;
+        const QMap<QString, qint64> report = budget.report();
+        for (auto it = report.constBegin(); it != report.constEnd(); ++it)
+            consumers.insert(it.key(), double(it.value()));
+        QJsonObject memory;
+        memory.insert("limit", double(budget.limit()));
+        memory.insert("usage", double(budget.usage()));
+        memory.insert("consumers", consumers);
+        return writeResponse(socket, 200, "application/json",
+                             QJsonDocument(memory).toJson(QJsonDocument::Compact), keepAlive);
+    }
+
+    if (parts.size() == 1 && parts.at(0) == "changes" && isGet) {
+        bool validSince = false;
+        const qint64 since = request.query.queryItemValue("since").toLongLong(&validSince);
+        if (!validSince || since < 0)
+            return writeResponse(socket, 400, "application/json", errorJson("Falta since"), keepAlive);
+        bool validLimit = false;
+        const int limit = request.query.queryItemValue("limit").toInt(&validLimit);
+        const int shardId = request.query.queryItemValue("shard").toInt();
+        if (!m_inventory->shardDatabasePaths().contains(shardId))
+            return writeResponse(socket, 404, "application/json", errorJson("Fragmento no encontrado"), keepAlive);
+        beginChunked(socket, "application/json", keepAlive);
+        QByteArray chunk("[");
+        bool first = true;
+        m_inventory->forEachChangeSince(since, [&](const ChangeRecord &change) -> bool {
+            if (!first)
+                chunk.append(',');
+            first = false;
+            chunk.append(changeJson(change));
+            if (chunk.size() >= kChunkBytes) {
+                writeChunk(socket, chunk);
+                chunk.clear();
+            }
+            return socket->state() == QAbstractSocket::ConnectedState;
+        }, validLimit && limit > 0 ? limit : -1, shardId);
+        chunk.append(']');
+        writeChunk(socket, chunk);
+        endChunked(socket);
+        return;
+    }
+
+    if (parts.size() == 1 && parts.at(0) == "export.csv" && isGet) {
+        beginChunked(socket, "text/csv; charset=utf-8", keepAlive);
+        QByteArray chunk = ComponentSchema::ListFields::labels(true).join(',').toUtf8() + '\n';
+        QString line;
+        auto appendCell = [&line](int column, const QString &text) {
+            if (column > 0)
+                line += ',';
+            line += text;
+        };
+        m_inventory->forEachComponent([&](const Component &c) -> bool {
+            line.resize(0);
+            ComponentSchema::ListFields::forEachText(c, appendCell);
+            line += '\n';
+            chunk.append(line.toUtf8());
+            if (chunk.size() >= kChunkBytes) {
+                writeChunk(socket, chunk);
+                chunk.clear();
+            }
+            return socket->state() == QAbstractSocket::ConnectedState;
+        });
+        writeChunk(socket, chunk);
+        endChunked(socket);
+        return;
+    }
+
+    writeResponse(socket, 404, "application/json", errorJson("Ruta no encontrada"), keepAlive);
+}
+
+/// @brief Escribe una respuesta completa.
+/// @param socket Conexión del cliente.
+/// @param status Código de estado HTTP.
+/// @param contentType Tipo MIME del cuerpo.
+/// @param body Cuerpo de la respuesta.
+/// @param keepAlive Mantener la conexión abierta.
+void ServerWorker::writeResponse(QTcpSocket *socket, int status, const QByteArray &contentType,
+                                 const QByteArray &body, bool keepAlive)
+{
+    QByteArray response;
+    response.reserve(body.size() + 160);
+    response.append("HTTP/1.1 ").append(QByteArray::number(status)).append(' ').append(statusText(status));
+    response.append("\r\nContent-Type: ").append(contentType);
+    response.append("\r\nContent-Length: ").append(QByteArray::number(body.size()));
+    response.append(keepAlive ? "\r\nConnection: keep-alive\r\n\r\n" : "\r\nConnection: close\r\n\r\n");
+    response.append(body);
+    socket->write(response);
+}
+
+/// @brief Escribe la cabecera de una respuesta 200 con Transfer-Encoding: chunked.
+/// @param socket Conexión del cliente.
+/// @param contentType Tipo MIME del cuerpo.
+/// @param keepAlive Mantener la conexión abierta.
+/// @param extraHeaders Cabeceras adicionales ya terminadas en "\r\n".
+void ServerWorker::beginChunked(QTcpSocket *socket, const QByteArray &contentType, bool keepAlive,
+                                const QByteArray &extraHeaders)
+{
+    QByteArray header("HTTP/1.1 200 OK\r\n");
+    header.append(extraHeaders);
+    header.append("Content-Type: ");
+    header.append(contentType);
+    header.append("\r\nTransfer-Encoding: chunked");
+    header.append(keepAlive ? "\r\nConnection: keep-alive\r\n\r\n" : "\r\nConnection: close\r\n\r\n");
+    socket->write(header);
+}
+
+/// @brief Escribe un trozo; si el cliente lee despacio, espera a que se vacíe el búfer de salida.
+/// @param socket Conexión del cliente.
+/// @param data Datos del trozo (se ignoran los trozos vacíos, que marcarían el final).
+void ServerWorker::writeChunk(QTcpSocket *socket, const QByteArray &data)
+{
+    if (data.isEmpty())
+        return;
+    socket->write(QByteArray::number(data.size(), 16) + "\r\n");
+    socket->write(data);
+    socket->write("\r\n");
+    while (socket->bytesToWrite() > kMaxPendingOutput
+           && socket->state() == QAbstractSocket::ConnectedState) {
+        if (!socket->waitForBytesWritten(5000))
+            break;
+    }
+}
+
+/// @brief Escribe el trozo final de una respuesta chunked.
+/// @param socket Conexión del cliente.
+void ServerWorker::endChunked(QTcpSocket *socket)
+{
+    socket->write("0\r\n\r\n");
+}
+
+/// @brief Envía un vector de componentes como array JSON en trozos de tamaño acotado.
+/// @param socket Conexión del cliente.
+/// @param components Resúmenes de los componentes a enviar.
+/// @param keepAlive Mantener la conexión abierta.
+/// @param truncated La lista se ha recortado por el límite de resultados.
+void ServerWorker::streamComponents(QTcpSocket *socket, const std::vector<ComponentSummary> &components, bool keepAlive,
+                                    bool truncated)
+{
+    beginChunked(socket, "application/json", keepAlive,
+                 truncated ? QByteArray("X-Result-Truncated: 1\r\n") : QByteArray());
+    QByteArray chunk("[");
+    for (std::size_t i = 0; i < components.size(); ++i) {
+        if (i > 0)
+            chunk.append(',');
+        chunk.append(summaryJson(components[i]));
+        if (chunk.size() >= kChunkBytes) {
+            writeChunk(socket, chunk);
+            chunk.clear();
+        }
+    }
+    chunk.append(']');
+    writeChunk(socket, chunk);
+    endChunked(socket);
+}
+
+/// @brief Serializa un componente como objeto JSON compacto.
+/// @param component Componente a serializar.
+/// @return Texto JSON en UTF-8.
+QByteArray ServerWorker::componentJson(const Component &component)
+{
+    return QJsonDocument(componentObject(component)).toJson(QJsonDocument::Compact);
+}
+
+/// @brief Serializa las columnas de listado de un componente como objeto JSON compacto.
+/// @param summary Resumen a serializar.
+/// @return Texto JSON en UTF-8.
+QByteArray ServerWorker::summaryJson(const ComponentSummary &summary)
+{
+    QJsonObject object;
+    ComponentSchema::ListFields::insertJson(object, summary);
+    return QJsonDocument(object).toJson(QJsonDocument::Compact);
+}
+
+/// @brief Serializa un cambio del registro como objeto JSON compacto.
+/// @param change Cambio a serializar.
+/// @return Texto JSON en UTF-8.
+QByteArray ServerWorker::changeJson(const ChangeRecord &change)
+{
+    static const char *const operations[] = { "insert", "update", "delete" };
+    QJsonObject object;
+    object.insert("seq", change.sequence);
+    object.insert("op", operations[change.operation]);
+    object.insert("id", change.componentId);
+    object.insert("changed_at", change.changedAt);
+    object.insert("component", change.exists
+                                   ? QJsonValue(componentObject(change.component))
+                                   : QJsonValue(QJsonValue::Null));
+    return QJsonDocument(object).toJson(QJsonDocument::Compact);
+}
+
+/// @brief Abre la conexión propia del trabajador la primera vez que se necesita.
+/// @return true si el inventario está inicializado.
+bool ServerWorker::ensureInventory()
+{
+    if (m_inventory)
+        return true;
+    InventoryManager *inventory = new InventoryManager(this);
+    if (!inventory->initialize(m_dbPath, m_connectionName)) {
+        delete inventory;
+        return false;
+    }
+    for (const ShardSpec &shard : m_shards) {
+        if (!inventory->addShard(shard)) {
+            delete inventory;
+            return false;
+        }
+    }
+    m_inventory = inventory;
+    return true;
+}
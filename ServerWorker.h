@@ -0,0 +1,128 @@
+/// @file ServerWorker.h
+/// @brief Declaración de la clase ServerWorker, que atiende conexiones HTTP en un hilo del servidor.
+
+#ifndef SERVERWORKER_H
+#define SERVERWORKER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QHash>
+#include <QUrlQuery>
+#include <vector>
+#include "Component.h"
+#include "DatabaseManager.h"
+#include "InventoryManager.h"
+
+class QTcpSocket;
+
+/// @class ServerWorker
+/// @brief Atiende las conexiones HTTP/1.1 asignadas a un hilo del servidor REST.
+///
+/// Cada trabajador vive en su propio QThread y posee un InventoryManager con una conexión
+/// SQLite propia, de modo que los trabajadores no comparten estado. Las conexiones se
+/// mantienen abiertas entre peticiones (keep-alive) y las respuestas con listas de
+/// componentes se envían con codificación por trozos (chunked) a medida que se generan.
+///
+/// Rutas disponibles:
+/// - GET  /components?q=texto&fuzzy=1&limit=N — búsqueda (sin q, todo el inventario).
+/// - GET  /components/{id} — un componente con sus campos de detalle (notas, hoja de datos).
+/// - GET  /lowstock?threshold=N&limit=M — componentes en o por debajo de su umbral.
+/// - POST /components/{id}/adjust — ajuste de stock; delta en el cuerpo JSON {"delta": N} o en ?delta=N.
+/// - GET  /purchases?from=AAAA-MM-DD&to=AAAA-MM-DD&type=T&limit=N — comprados en el intervalo,
+///   por fecha de compra (sin from o to, abierto por ese extremo; con olderThan=D, comprados hace más de D días).
+/// - GET  /aging?bounds=30,90,180,365 — histograma de antigüedad por tipo y franja de días.
+/// - GET  /changes?since=N&limit=M&shard=K — cambios del fragmento K posteriores a la secuencia N.
+/// - GET  /export.csv — exportación CSV de todo el inventario.
+/// - GET  /memory — memoria contabilizada por consumidor y límite del presupuesto.
+///
+/// Las búsquedas, /lowstock y /purchases devuelven como mucho kMaxResultRows componentes (o limit, si
+/// es menor); si el resultado se ha recortado, la respuesta incluye X-Result-Truncated: 1.
+/// Sin q, /components y /export.csv recorren el inventario en flujo y no tienen límite.
+class ServerWorker : public QObject {
+    Q_OBJECT
+
+public:
+    /// @brief Constructor de ServerWorker.
+    /// @param dbPath Ruta de la base de datos.
+    /// @param connectionName Nombre de la conexión SQLite propia del trabajador.
+    /// @param shards Fragmentos por almacén que se abren junto a la base de datos principal.
+    /// @param parent Objeto padre en la jerarquía de Qt (por defecto nullptr).
+    ServerWorker(const QString &dbPath, const QString &connectionName,
+                 const std::vector<ShardSpec> &shards = std::vector<ShardSpec>(), QObject *parent = nullptr);
+
+    /// @brief Destructor de ServerWorker.
+    ~ServerWorker();
+
+    /// @brief Serializa un componente como objeto JSON compacto.
+    static QByteArray componentJson(const Component &component);
+
+    /// @brief Serializa el resumen de un componente (sin campos de detalle) como objeto JSON compacto.
+    static QByteArray summaryJson(const ComponentSummary &summary);
+
+    /// @brief Serializa un cambio del registro como objeto JSON compacto
+    ///        ({"seq", "op", "id", "changed_at", "component"}; component es null si la fila ya no existe).
+    static QByteArray changeJson(const ChangeRecord &change);
+
+public slots:
+    /// @brief Toma posesión de un socket aceptado por el servidor (debe invocarse en el hilo del trabajador).
+    /// @param socketDescriptor Descriptor nativo del socket.
+    void handleConnection(qintptr socketDescriptor);
+
+private:
+    /// @brief Petición HTTP ya analizada.
+    struct HttpRequest {
+        QByteArray method;     ///< Método (GET, POST...).
+        QString path;          ///< Ruta sin la cadena de consulta.
+        QUrlQuery query;       ///< Parámetros de la cadena de consulta.
+        QByteArray body;       ///< Cuerpo de la petición.
+        bool keepAlive;        ///< Mantener la conexión abierta tras responder.
+    };
+
+    /// @brief Lee los datos disponibles y procesa todas las peticiones completas del búfer.
+    /// @param socket Conexión del cliente.
+    void readClient(QTcpSocket *socket);
+
+    /// @brief Extrae una petición completa del principio del búfer.
+    /// @param buffer Datos recibidos; se consume la petición extraída.
+    /// @param request Petición analizada.
+    /// @param error Recibe true si la petición está mal formada.
+    /// @return true si se ha extraído una petición completa.
+    static bool takeRequest(QByteArray &buffer, HttpRequest &request, bool &error);
+
+    /// @brief Ejecuta la ruta correspondiente a la petición y escribe la respuesta.
+    /// @param socket Conexión del cliente.
+    /// @param request Petición a atender.
+    void dispatch(QTcpSocket *socket, const HttpRequest &request);
+
+    /// @brief Escribe una respuesta completa con Content-Length.
+    void writeResponse(QTcpSocket *socket, int status, const QByteArray &contentType,
+                       const QByteArray &body, bool keepAlive);
+
+    /// @brief Escribe la cabecera de una respuesta con codificación por trozos.
+    /// @param extraHeaders Cabeceras adicionales, cada una terminada en "\r\n".
+    void beginChunked(QTcpSocket *socket, const QByteArray &contentType, bool keepAlive,
+                      const QByteArray &extraHeaders = QByteArray());
+
+    /// @brief Escribe un trozo de una respuesta chunked, esperando si el búfer de salida crece demasiado.
+    void writeChunk(QTcpSocket *socket, const QByteArray &data);
+
+    /// @brief Cierra una respuesta chunked.
+    void endChunked(QTcpSocket *socket);
+
+    /// @brief Envía una lista de componentes como array JSON por trozos.
+    /// @param truncated Indica con X-Result-Truncated que la lista se ha recortado.
+    void streamComponents(QTcpSocket *socket, const std::vector<ComponentSummary> &components, bool keepAlive,
+                          bool truncated = false);
+
+    /// @brief Abre la base de datos del trabajador en la primera petición.
+    /// @return true si el inventario está disponible.
+    bool ensureInventory();
+
+    QString m_dbPath;                          ///< Ruta de la base de datos.
+    QString m_connectionName;                  ///< Nombre de la conexión SQLite propia.
+    std::vector<ShardSpec> m_shards;           ///< Fragmentos por almacén.
+    InventoryManager *m_inventory;             ///< Inventario del trabajador (creado en su hilo).
+    QHash<QTcpSocket *, QByteArray> m_buffers; ///< Datos recibidos pendientes por conexión.
+};
+
+#endif // SERVERWORKER_H
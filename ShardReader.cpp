@@ -0,0 +1,60 @@
+/// @file ShardReader.cpp
+/// @brief Implementación del hilo lector de un fragmento del inventario.
+
+#include "ShardReader.h"
+#include "DatabaseManager.h"
+#include <QSqlDatabase>
+
+/// @brief Constructor de ShardReader.
+/// @param dbPath Ruta de la base de datos del fragmento.
+/// @param connectionName Nombre único de la conexión de lectura.
+ShardReader::ShardReader(const QString &dbPath, const QString &connectionName)
+    : m_dbPath(dbPath)
+    , m_connectionName(connectionName)
+    , m_stopping(false)
+    , m_thread(&ShardReader::loop, this)
+{}
+
+/// @brief Destructor de ShardReader. Detiene el hilo tras atender las consultas pendientes.
+ShardReader::~ShardReader()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_cond.notify_all();
+    m_thread.join();
+}
+
+/// @brief Añade una tarea a la cola del hilo lector.
+/// @param task Tarea que recibe el gestor (nullptr si la conexión no pudo abrirse).
+void ShardReader::enqueue(const std::function<void(DatabaseManager *)> &task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(task);
+    }
+    m_cond.notify_one();
+}
+
+/// @brief Bucle del hilo lector. La conexión se crea, usa y elimina dentro de este hilo.
+void ShardReader::loop()
+{
+    {
+        DatabaseManager db;
+        const bool open = db.openDatabase(m_dbPath, m_connectionName);
+        for (;;) {
+            std::function<void(DatabaseManager *)> task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cond.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+                if (m_tasks.empty())
+                    break;
+                task = m_tasks.front();
+                m_tasks.pop_front();
+            }
+            task(open ? &db : nullptr);
+        }
+    }
+    QSqlDatabase::removeDatabase(m_connectionName);
+}
@@ -0,0 +1,67 @@
+/// @file ShardReader.h
+/// @brief Declaración de la clase ShardReader, hilo lector dedicado a un fragmento del inventario.
+
+#ifndef SHARDREADER_H
+#define SHARDREADER_H
+
+#include <QString>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+class DatabaseManager;
+
+/// @class ShardReader
+/// @brief Ejecuta consultas de lectura sobre un fragmento en un hilo propio con su propia conexión.
+///
+/// Qt solo permite usar una conexión SQL desde el hilo que la crea, así que cada fragmento
+/// tiene un hilo lector que abre su conexión al arrancar y atiende las consultas en orden.
+/// Con WAL, las lecturas de este hilo no bloquean ni son bloqueadas por la conexión de
+/// escritura, pero solo ven los datos ya confirmados.
+class ShardReader {
+public:
+    /// @brief Constructor de ShardReader. Arranca el hilo y abre la conexión de lectura.
+    /// @param dbPath Ruta de la base de datos del fragmento.
+    /// @param connectionName Nombre único de la conexión de lectura.
+    ShardReader(const QString &dbPath, const QString &connectionName);
+
+    /// @brief Destructor de ShardReader. Atiende las consultas pendientes, cierra la conexión y espera al hilo.
+    ~ShardReader();
+
+    /// @brief Encola una consulta para el hilo lector.
+    /// @param query Función que recibe el gestor del fragmento y devuelve el resultado.
+    /// @return Futuro con el resultado; si la conexión no pudo abrirse, el valor por defecto de T.
+    template <typename T>
+    std::future<T> run(const std::function<T(DatabaseManager &)> &query)
+    {
+        auto task = std::make_shared<std::packaged_task<T(DatabaseManager *)>>(
+            [query](DatabaseManager *db) { return db ? query(*db) : T(); });
+        std::future<T> result = task->get_future();
+        enqueue([task](DatabaseManager *db) { (*task)(db); });
+        return result;
+    }
+
+private:
+    ShardReader(const ShardReader &) = delete;
+    ShardReader &operator=(const ShardReader &) = delete;
+
+    /// @brief Añade una tarea a la cola y despierta al hilo.
+    void enqueue(const std::function<void(DatabaseManager *)> &task);
+
+    /// @brief Bucle del hilo: abre la conexión y ejecuta las tareas hasta que se detiene.
+    void loop();
+
+    QString m_dbPath;                                      ///< Ruta de la base de datos.
+    QString m_connectionName;                              ///< Nombre de la conexión de lectura.
+    std::mutex m_mutex;                                    ///< Protege la cola y m_stopping.
+    std::condition_variable m_cond;                        ///< Avisa de tareas nuevas o de parada.
+    std::deque<std::function<void(DatabaseManager *)>> m_tasks; ///< Consultas pendientes.
+    bool m_stopping;                                       ///< Se ha pedido detener el hilo.
+    std::thread m_thread;                                  ///< Hilo lector.
+};
+
+#endif // SHARDREADER_H
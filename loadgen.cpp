@@ -0,0 +1,46 @@
+/// @file loadgen.cpp
+/// @brief Punto de entrada del generador de carga del gestor de inventario.
+#include "LoadGenerator.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <cstdio>
+
+/// @brief Función principal del generador de carga.
+///        Interpreta las opciones, ejecuta la carga y devuelve 0 si los invariantes se cumplen.
+/// @param argc Número de argumentos de línea de comandos.
+/// @param argv Vector de cadenas con cada argumento de línea de comandos.
+/// @return 0 si la carga termina y los invariantes se cumplen; 1 en caso contrario.
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("GestorInventarioLoadGen");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Generador de carga concurrente sobre InventoryManager.");
+    parser.addHelpOption();
+    QCommandLineOption dbOption("db", "Base de datos compartida.", "ruta", "inventory.db");
+    QCommandLineOption threadsOption("threads", "Numero de hilos.", "n", "4");
+    QCommandLineOption opsOption("ops", "Operaciones por hilo.", "n", "1000");
+    QCommandLineOption mixOption("mix", "Mezcla de operaciones (search,add,update,remove,adjust,lowstock).",
+                                 "mezcla", "search=40,add=15,update=20,remove=10,adjust=10,lowstock=5");
+    QCommandLineOption countersOption("counters", "Filas contador compartidas.", "n", "8");
+    QCommandLineOption seedOption("seed", "Semilla aleatoria.", "n", "1");
+    QCommandLineOption keepOption("keep", "Conservar las filas creadas al terminar.");
+    parser.addOptions({ dbOption, threadsOption, opsOption, mixOption, countersOption, seedOption, keepOption });
+    parser.process(app);
+
+    LoadGeneratorOptions options;
+    options.dbPath = parser.value(dbOption);
+    options.threads = qMax(1, parser.value(threadsOption).toInt());
+    options.operationsPerThread = qMax(0, parser.value(opsOption).toInt());
+    options.counterRows = qMax(0, parser.value(countersOption).toInt());
+    options.seed = parser.value(seedOption).toUInt();
+    options.cleanup = !parser.isSet(keepOption);
+    if (!LoadGenerator::parseMix(parser.value(mixOption), options.weights)) {
+        std::fprintf(stderr, "Mezcla de operaciones no valida: %s\n", qPrintable(parser.value(mixOption)));
+        return 1;
+    }
+
+    QTextStream out(stdout);
+    LoadGenerator generator(options);
+    return generator.run(out) ? 0 : 1;
+}
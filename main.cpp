@@ -1,17 +1,365 @@
 /// @file main.cpp
 /// @brief Punto de entrada de la aplicación de inventario.
 #include "MainWindow.h"
+#include "InventoryManager.h"
+#include "InventoryServer.h"
+#include "MemoryBudget.h"
+#include "ReportGenerator.h"
+#include "ScanPipeline.h"
+#include "ServerWorker.h"
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+#include <QThread>
+#include <cstdio>
+#include <thread>
+
+/// @brief Interpreta las opciones --shard ("id:ALMACEN=ruta").
+/// @param values Valores de la opción.
+/// @param shards Recibe los fragmentos interpretados.
+/// @return true si todas las especificaciones son válidas.
+static bool parseShards(const QStringList &values, std::vector<ShardSpec> &shards) {
+    for (const QString &value : values) {
+        ShardSpec spec;
+        if (!InventoryManager::parseShardSpec(value, spec)) {
+            std::fprintf(stderr, "Fragmento no valido: %s\n", qPrintable(value));
+            return false;
+        }
+        shards.push_back(spec);
+    }
+    return true;
+}
+
+/// @brief Abre la base de datos principal y los fragmentos por almacén.
+/// @param inventory Gestor a inicializar.
+/// @param dbPath Ruta de la base de datos principal (fragmento 0).
+/// @param shards Fragmentos adicionales.
+/// @return true si todas las bases de datos se abren correctamente.
+static bool openInventory(InventoryManager &inventory, const QString &dbPath, const std::vector<ShardSpec> &shards) {
+    if (!inventory.initialize(dbPath)) {
+        std::fprintf(stderr, "No se pudo abrir la base de datos.\n");
+        return false;
+    }
+    for (const ShardSpec &shard : shards) {
+        if (!inventory.addShard(shard)) {
+            std::fprintf(stderr, "No se pudo abrir el fragmento %d (%s).\n", shard.id, qPrintable(shard.dbPath));
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief Escribe el resultado de una pasada de mantenimiento, una línea por fragmento.
+/// @param stats Resultado de cada fragmento por número.
+static void printMaintenance(const QMap<int, MaintenanceStats> &stats) {
+    for (auto it = stats.constBegin(); it != stats.constEnd(); ++it) {
+        const MaintenanceStats &s = it.value();
+        std::printf("Fragmento %d: %lld -> %lld bytes, %lld -> %lld paginas libres, "
+                    "compactacion %lld ms%s, ANALYZE %lld ms\n",
+                    it.key(), s.bytesBefore, s.bytesAfter, s.freePagesBefore, s.freePagesAfter,
+                    s.vacuumMs, s.fullVacuum ? " (completa)" : "", s.analyzeMs);
+    }
+    std::fflush(stdout);
+}
+
+/// @brief Ejecuta la aplicación en modo servidor REST, sin interfaz gráfica.
+/// @param argc Número de argumentos de línea de comandos.
+/// @param argv Vector de cadenas con cada argumento de línea de comandos.
+/// @return Código de salida del bucle de eventos, o 1 si el servidor no puede arrancar.
+static int runServer(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Gestor de inventario en modo servidor REST/JSON.");
+    parser.addHelpOption();
+    QCommandLineOption serverOption("server", "Ejecutar como servidor REST/JSON.");
+    QCommandLineOption dbOption("db", "Ruta de la base de datos.", "ruta", "inventory.db");
+    QCommandLineOption portOption("port", "Puerto TCP.", "puerto", "8080");
+    QCommandLineOption bindOption("bind", "Direccion de escucha.", "direccion", "127.0.0.1");
+    QCommandLineOption workersOption("workers", "Hilos trabajadores.", "n",
+                                     QString::number(qMax(2, QThread::idealThreadCount())));
+    QCommandLineOption shardOption("shard", "Fragmento por almacen (id:ALMACEN=ruta); se puede repetir.", "spec");
+    QCommandLineOption memoryOption("memory-mb", "Presupuesto de memoria en MB (0 = sin limite).", "mb");
+    QCommandLineOption maintenanceOption("maintenance-hours", "Horas entre mantenimientos (0 = desactivado).",
+                                         "horas", "24");
+    parser.addOptions({ serverOption, dbOption, portOption, bindOption, workersOption, shardOption, memoryOption,
+                        maintenanceOption });
+    parser.process(app);
+    if (parser.isSet(memoryOption))
+        MemoryBudget::global().setLimit(parser.value(memoryOption).toLongLong() * 1024 * 1024);
+
+    // La conexión principal aplica las migraciones antes de que arranquen los trabajadores
+    std::vector<ShardSpec> shards;
+    if (!parseShards(parser.values(shardOption), shards))
+        return 1;
+    InventoryManager inventory;
+    if (!openInventory(inventory, parser.value(dbOption), shards))
+        return 1;
+    inventory.startBackgroundMigrations();
+    // Un intervalo de int admite hasta 596 horas
+    const int maintenanceHours = qBound(0, parser.value(maintenanceOption).toInt(), 596);
+    QObject::connect(&inventory, &InventoryManager::maintenanceFinished,
+                     [](bool ok, const QMap<int, MaintenanceStats> &stats) {
+        if (!ok)
+            std::fprintf(stderr, "Error en el mantenimiento programado.\n");
+        printMaintenance(stats);
+    });
+    inventory.setMaintenanceInterval(maintenanceHours * 3600 * 1000);
+
+    InventoryServer server(parser.value(dbOption), parser.value(workersOption).toInt());
+    server.setShards(shards);
+    const quint16 port = quint16(parser.value(portOption).toUInt());
+    if (!server.start(QHostAddress(parser.value(bindOption)), port))
+        return 1;
+    std::printf("Servidor escuchando en %s:%u\n", qPrintable(parser.value(bindOption)), unsigned(port));
+    std::fflush(stdout);
+    return app.exec();
+}
+
+/// @brief Exporta el inventario a un archivo sin abrir la interfaz gráfica (p. ej. desde cron).
+///        El formato se elige por la extensión: .csv o .gicf, con .gz para comprimir en gzip.
+/// @param argc Número de argumentos de línea de comandos.
+/// @param argv Vector de cadenas con cada argumento de línea de comandos.
+/// @return 0 si la exportación termina correctamente; 1 en caso de error.
+static int runExport(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Exportacion del inventario sin interfaz grafica.");
+    parser.addHelpOption();
+    QCommandLineOption exportOption("export", "Archivo de salida (.csv, .gicf, opcionalmente .gz).", "archivo");
+    QCommandLineOption dbOption("db", "Ruta de la base de datos.", "ruta", "inventory.db");
+    QCommandLineOption levelOption("level", "Nivel de compresion gzip (0-9).", "nivel", "-1");
+    QCommandLineOption shardOption("shard", "Fragmento por almacen (id:ALMACEN=ruta); se puede repetir.", "spec");
+    parser.addOptions({ exportOption, dbOption, levelOption, shardOption });
+    parser.process(app);
+
+    std::vector<ShardSpec> shards;
+    InventoryManager inventory;
+    if (!parseShards(parser.values(shardOption), shards)
+        || !openInventory(inventory, parser.value(dbOption), shards))
+        return 1;
+
+    ReportGenerator reporter;
+    reporter.setCompression(ReportGenerator::AutoCompression, parser.value(levelOption).toInt());
+    const QString filePath = parser.value(exportOption);
+    QString baseName = filePath;
+    if (baseName.endsWith(".gz", Qt::CaseInsensitive))
+        baseName.chop(3);
+    auto source = [&inventory](const std::function<bool(const Component &)> &visitor) {
+        return inventory.forEachComponent(visitor);
+    };
+
+    bool ok = false;
+    if (baseName.endsWith(".gicf", Qt::CaseInsensitive)) {
+        ok = reporter.generateColumnar(filePath, source);
+    } else if (baseName.endsWith(".csv", Qt::CaseInsensitive)) {
+        ok = reporter.generateCSV(filePath, source);
+    } else {
+        std::fprintf(stderr, "Extension no reconocida: %s\n", qPrintable(filePath));
+        return 1;
+    }
+    if (!ok) {
+        std::fprintf(stderr, "No se pudo generar %s\n", qPrintable(filePath));
+        return 1;
+    }
+    return 0;
+}
+
+/// @brief Escribe en la salida estándar los cambios posteriores a una secuencia, uno por línea en JSON.
+///        La secuencia del último cambio escrito es la que debe pasarse en la siguiente llamada.
+/// @param argc Número de argumentos de línea de comandos.
+/// @param argv Vector de cadenas con cada argumento de línea de comandos.
+/// @return 0 si la lectura termina correctamente; 1 en caso de error.
+static int runChangesSince(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Cambios del inventario posteriores a una secuencia (JSON por linea).");
+    parser.addHelpOption();
+    QCommandLineOption sinceOption("changes-since", "Ultima secuencia ya procesada (0 para todo).", "n");
+    QCommandLineOption dbOption("db", "Ruta de la base de datos.", "ruta", "inventory.db");
+    QCommandLineOption limitOption("limit", "Numero maximo de cambios.", "n", "-1");
+    parser.addOptions({ sinceOption, dbOption, limitOption });
+    parser.process(app);
+
+    bool validSince = false;
+    const qint64 since = parser.value(sinceOption).toLongLong(&validSince);
+    if (!validSince || since < 0) {
+        std::fprintf(stderr, "Secuencia no valida.\n");
+        return 1;
+    }
+    InventoryManager inventory;
+    if (!inventory.initialize(parser.value(dbOption))) {
+        std::fprintf(stderr, "No se pudo abrir la base de datos.\n");
+        return 1;
+    }
+    const bool ok = inventory.forEachChangeSince(since, [](const ChangeRecord &change) -> bool {
+        const QByteArray line = ServerWorker::changeJson(change);
+        std::fwrite(line.constData(), 1, std::size_t(line.size()), stdout);
+        std::fputc('\n', stdout);
+        return !std::ferror(stdout);
+    }, parser.value(limitOption).toInt());
+    std::fflush(stdout);
+    return ok ? 0 : 1;
+}
+
+/// @brief Copia en línea la base de datos y sus fragmentos a un directorio (p. ej. desde cron).
+///        La copia es consistente aunque la aplicación o el servidor estén escribiendo.
+/// @param argc Número de argumentos de línea de comandos.
+/// @param argv Vector de cadenas con cada argumento de línea de comandos.
+/// @return 0 si se copian todos los fragmentos; 1 en caso de error.
+static int runBackup(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Copia en linea del inventario.");
+    parser.addHelpOption();
+    QCommandLineOption backupOption("backup", "Directorio destino de las copias.", "directorio");
+    QCommandLineOption dbOption("db", "Ruta de la base de datos.", "ruta", "inventory.db");
+    QCommandLineOption shardOption("shard", "Fragmento por almacen (id:ALMACEN=ruta); se puede repetir.", "spec");
+    parser.addOptions({ backupOption, dbOption, shardOption });
+    parser.process(app);
+
+    std::vector<ShardSpec> shards;
+    InventoryManager inventory;
+    if (!parseShards(parser.values(shardOption), shards)
+        || !openInventory(inventory, parser.value(dbOption), shards))
+        return 1;
+
+    QStringList files;
+    if (!inventory.backup(parser.value(backupOption), &files)) {
+        std::fprintf(stderr, "No se pudo completar la copia en %s\n", qPrintable(parser.value(backupOption)));
+        return 1;
+    }
+    for (const QString &file : files)
+        std::printf("%s\n", qPrintable(file));
+    return 0;
+}
+
+/// @brief Compacta la base de datos y sus fragmentos y actualiza sus estadísticas (p. ej. desde cron).
+///        Escribe los tamaños y tiempos de cada fragmento.
+/// @param argc Número de argumentos de línea de comandos.
+/// @param argv Vector de cadenas con cada argumento de línea de comandos.
+/// @return 0 si el mantenimiento se completa; 1 en caso de error.
+static int runMaintain(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Mantenimiento del inventario (compactacion y ANALYZE).");
+    parser.addHelpOption();
+    QCommandLineOption maintainOption("maintain", "Compactar y actualizar las estadisticas.");
+    QCommandLineOption dbOption("db", "Ruta de la base de datos.", "ruta", "inventory.db");
+    QCommandLineOption shardOption("shard", "Fragmento por almacen (id:ALMACEN=ruta); se puede repetir.", "spec");
+    parser.addOptions({ maintainOption, dbOption, shardOption });
+    parser.process(app);
+
+    std::vector<ShardSpec> shards;
+    InventoryManager inventory;
+    if (!parseShards(parser.values(shardOption), shards)
+        || !openInventory(inventory, parser.value(dbOption), shards))
+        return 1;
+
+    QMap<int, MaintenanceStats> stats;
+    const bool ok = inventory.maintain(&stats);
+    printMaintenance(stats);
+    if (!ok) {
+        std::fprintf(stderr, "No se pudo completar el mantenimiento.\n");
+        return 1;
+    }
+    return 0;
+}
+
+/// @brief Recuento con lector de códigos desde la entrada estándar, sin interfaz gráfica.
+///        Cada línea es un código, opcionalmente seguido de la cantidad ("codigo 3"); los
+///        ajustes se confirman por lotes y los códigos desconocidos se informan en stderr.
+/// @param argc Número de argumentos de línea de comandos.
+/// @param argv Vector de cadenas con cada argumento de línea de comandos.
+/// @return 0 si todas las lecturas se confirman; 1 en caso de error.
+static int runScan(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Recuento de stock con lector de codigos de barras (entrada estandar).");
+    parser.addHelpOption();
+    QCommandLineOption scanOption("scan", "Leer codigos de barras de la entrada estandar.");
+    QCommandLineOption dbOption("db", "Ruta de la base de datos.", "ruta", "inventory.db");
+    QCommandLineOption shardOption("shard", "Fragmento por almacen (id:ALMACEN=ruta); se puede repetir.", "spec");
+    QCommandLineOption intervalOption("flush-ms", "Tiempo maximo sin confirmar una lectura.", "ms", "500");
+    QCommandLineOption batchOption("batch", "Lecturas que fuerzan la confirmacion.", "n", "200");
+    parser.addOptions({ scanOption, dbOption, shardOption, intervalOption, batchOption });
+    parser.process(app);
+
+    std::vector<ShardSpec> shards;
+    InventoryManager inventory;
+    if (!parseShards(parser.values(shardOption), shards)
+        || !openInventory(inventory, parser.value(dbOption), shards))
+        return 1;
+
+    ScanPipeline pipeline(&inventory);
+    pipeline.setFlushPolicy(parser.value(intervalOption).toInt(), parser.value(batchOption).toInt());
+    int unknown = 0;
+    QObject::connect(&pipeline, &ScanPipeline::unknownCode, [&unknown](const QString &code) {
+        ++unknown;
+        std::fprintf(stderr, "Codigo desconocido: %s\n", qPrintable(code));
+    });
+    // Los lotes que fallan se reintentan en la siguiente confirmación
+    QObject::connect(&pipeline, &ScanPipeline::flushed, [](bool flushed, int components, int scans) {
+        std::fprintf(stderr, "%s: %d lecturas, %d componentes\n",
+                     flushed ? "Confirmado" : "Error al confirmar", scans, components);
+    });
+
+    // La entrada estándar se lee en un hilo aparte y cada lectura se entrega al bucle de
+    // eventos, de modo que el temporizador de --flush-ms confirma el lote durante las pausas
+    // del lector. Al llegar al final de la entrada se termina el bucle tras la última lectura.
+    std::thread reader([&app, &pipeline]() {
+        QTextStream in(stdin);
+        QString line;
+        while (in.readLineInto(&line)) {
+            const QStringList fields = line.split(' ', Qt::SkipEmptyParts);
+            if (fields.isEmpty())
+                continue;
+            bool validDelta = true;
+            const int delta = fields.size() > 1 ? fields.at(1).toInt(&validDelta) : 1;
+            if (!validDelta) {
+                std::fprintf(stderr, "Cantidad no valida: %s\n", qPrintable(line));
+                continue;
+            }
+            const QString code = fields.at(0);
+            QMetaObject::invokeMethod(&pipeline, [&pipeline, code, delta]() {
+                pipeline.scan(code, delta);
+            }, Qt::QueuedConnection);
+        }
+        QMetaObject::invokeMethod(&app, "quit", Qt::QueuedConnection);
+    });
+    app.exec();
+    reader.join();
+    const bool ok = pipeline.flush();
+    return ok && unknown == 0 ? 0 : 1;
+}
 
 /// @brief Función principal de la aplicación.
-///        Inicializa QApplication, crea y muestra la ventana principal.
+///        Inicializa QApplication, crea y muestra la ventana principal. Con --server
+///        arranca en su lugar el servidor REST sin interfaz gráfica y con --export
+///        exporta el inventario a un archivo y termina; con --changes-since escribe
+///        los cambios posteriores a una secuencia y termina; con --scan hace un recuento
+///        con los códigos leídos de la entrada estándar; con --backup copia la base de datos
+///        en línea y con --maintain la compacta y actualiza sus estadísticas.
 /// @param argc Número de argumentos de línea de comandos.
 /// @param argv Vector de cadenas con cada argumento de línea de comandos.
 /// @return Resultado de la ejecución de la aplicación (0 si finaliza correctamente).
 int main(int argc, char *argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], "--server") == 0)
+            return runServer(argc, argv);
+        if (qstrcmp(argv[i], "--export") == 0)
+            return runExport(argc, argv);
+        if (qstrcmp(argv[i], "--changes-since") == 0)
+            return runChangesSince(argc, argv);
+        if (qstrcmp(argv[i], "--scan") == 0)
+            return runScan(argc, argv);
+        if (qstrcmp(argv[i], "--backup") == 0)
+            return runBackup(argc, argv);
+        if (qstrcmp(argv[i], "--maintain") == 0)
+            return runMaintain(argc, argv);
+    }
+
     QApplication a(argc, argv);  ///< Objeto de aplicación Qt.
     MainWindow w;                ///< Ventana principal de la aplicación.
     w.show();                    ///< Muestra la ventana principal.
     return a.exec();             ///< Entra en el bucle de eventos Qt.
 }
-